@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Time levelized gate evaluation (VVP_LEVELIZE) on a large
+ * combinational netlist.
+ *
+ * The netlist is a butterfly network of 1 bit AND, OR and XOR gates,
+ * <width> gates wide and <depth> layers deep. Gate i of a layer takes
+ * gate i^(1<<k) of the layer before it, and gate i of a layer up to
+ * three layers before it, as inputs. So every output sits behind many
+ * reconvergent paths of different lengths. That is where evaluating
+ * the gates in level order saves work: a gate is evaluated once after
+ * its inputs settle instead of once per input change. The gate types
+ * are mixed within each layer, which exercises the per-type buckets.
+ *
+ * A stimulus event changes random inputs once per time step, for the
+ * given number of steps. The program builds the netlist, ranks it if
+ * levelizing is on, runs the scheduler and prints the time taken, the
+ * number of gate evaluations and a checksum of the last layer. The
+ * checksum must be the same with and without levelizing.
+ *
+ * Build vvp in a configured tree first. Then, in the vvp directory,
+ * rename the main() of vvp and link this program with the vvp objects
+ * and the libraries listed as LIBS in vvp/Makefile:
+ *
+ *    cd vvp
+ *    objcopy --redefine-sym main=vvp_main main.o bench_main.o
+ *    g++ -O2 -I. -I.. -rdynamic -o levelize ../bench/levelize.cc \
+ *        bench_main.o $(ls *.o | grep -v '^main.o$' | grep -v '^bench_main.o$') \
+ *        -lm -lbz2 -lz -lpthread -lhistory -lreadline -ltermcap -ldl
+ *    ./levelize 0 4096 32 20
+ *    ./levelize 1 4096 32 20
+ *
+ * The arguments are: levelize (0 or 1), width (a power of 2), depth
+ * and the number of time steps.
+ */
+
+# include  "config.h"
+# include  "logic.h"
+# include  "schedule.h"
+# include  "statistics.h"
+# include  <cstdio>
+# include  <cstdlib>
+# include  <ctime>
+# include  <vector>
+
+using namespace std;
+
+/*
+ * The probe is linked to a gate output of the last layer and keeps
+ * the last value it received.
+ */
+class bench_probe : public vvp_net_fun_t {
+
+    public:
+      bench_probe() : value(BIT4_X) { }
+
+      void recv_vec4(vvp_net_ptr_t, const vvp_vector4_t&bit, vvp_context_t)
+      { value = bit.value(0); }
+
+      vvp_bit4_t value;
+};
+
+/*
+ * The stimulus sets all the inputs in the first time step. After that
+ * it changes about an eighth of them in each step, and schedules
+ * itself again for the next step until it has run the given number
+ * of steps.
+ */
+class bench_stimulus : public vvp_gen_event_s {
+
+    public:
+      bench_stimulus(const vector<vvp_net_t*>&inputs, unsigned steps)
+      : inputs_(inputs), steps_(steps), seed_(1), started_(false) { }
+
+      void run_run();
+
+    private:
+      unsigned rand_(void)
+      { seed_ = seed_ * 1103515245 + 12345;
+	return seed_ >> 16;
+      }
+
+      const vector<vvp_net_t*>&inputs_;
+      unsigned steps_;
+      unsigned seed_;
+      bool started_;
+};
+
+void bench_stimulus::run_run()
+{
+      static const vvp_vector4_t bit0 (1, BIT4_0);
+      static const vvp_vector4_t bit1 (1, BIT4_1);
+
+      for (size_t idx = 0 ; idx < inputs_.size() ; idx += 1) {
+	    unsigned val = rand_();
+	    if (started_ && (val & 7) != 0)
+		  continue;
+	    inputs_[idx]->send_vec4((val & 8)? bit1 : bit0, 0);
+      }
+      started_ = true;
+
+      if (steps_ > 0) {
+	    steps_ -= 1;
+	    schedule_generic(this, 1, false);
+      }
+}
+
+/*
+ * Make a two input gate. The logic functors have four inputs, so the
+ * two that are not used are tied to a value that does not change the
+ * result, as the compiler does for the gates in a design.
+ */
+static vvp_net_t* make_gate(unsigned type)
+{
+      static const vvp_vector4_t bit0 (1, BIT4_0);
+      static const vvp_vector4_t bit1 (1, BIT4_1);
+
+      vvp_net_t*net = new vvp_net_t;
+      const vvp_vector4_t*tie = &bit0;
+      switch (type % 4) {
+	  case 0:
+	    net->fun = new vvp_fun_and(1, false);
+	    tie = &bit1;
+	    break;
+	  case 1:
+	    net->fun = new vvp_fun_or(1, false);
+	    break;
+	  default:
+	    net->fun = new vvp_fun_xor(1, false);
+	    break;
+      }
+      net->fun->recv_vec4(vvp_net_ptr_t(net, 2), *tie, 0);
+      net->fun->recv_vec4(vvp_net_ptr_t(net, 3), *tie, 0);
+      if (schedule_levelize_flag)
+	    schedule_levelize_net(net);
+      return net;
+}
+
+int main(int argc, char*argv[])
+{
+      if (argc != 5) {
+	    fprintf(stderr, "usage: %s <levelize> <width> <depth> <steps>\n",
+		    argv[0]);
+	    return 1;
+      }
+
+      schedule_levelize_flag = strtoul(argv[1], 0, 0) != 0;
+      unsigned width = strtoul(argv[2], 0, 0);
+      unsigned depth = strtoul(argv[3], 0, 0);
+      unsigned steps = strtoul(argv[4], 0, 0);
+
+      unsigned log_width = 0;
+      while ((2U << log_width) <= width)
+	    log_width += 1;
+      if (width == 0 || (1U << log_width) != width || log_width == 0) {
+	    fprintf(stderr, "%s: width must be a power of 2 above 1\n",
+		    argv[0]);
+	    return 1;
+      }
+
+      vector<vvp_net_t*> inputs (width);
+      for (unsigned idx = 0 ; idx < width ; idx += 1)
+	    inputs[idx] = new vvp_net_t;
+
+	// Layer 0 is the inputs, and layer lev+1 is the gates of
+	// level lev.
+      vector< vector<vvp_net_t*> > layers (depth+1);
+      layers[0] = inputs;
+      for (unsigned lev = 0 ; lev < depth ; lev += 1) {
+	    const vector<vvp_net_t*>&prev = layers[lev];
+	    vector<vvp_net_t*>&cur = layers[lev+1];
+	    unsigned mask = 1U << (lev % log_width);
+	    cur.resize(width);
+	    for (unsigned idx = 0 ; idx < width ; idx += 1) {
+		  unsigned skip = idx % 3;
+		  const vector<vvp_net_t*>&from
+			= layers[lev < skip? 0 : lev - skip];
+		  cur[idx] = make_gate(lev + idx);
+		  from[idx]->link(vvp_net_ptr_t(cur[idx], 0));
+		  prev[idx^mask]->link(vvp_net_ptr_t(cur[idx], 1));
+	    }
+      }
+      const vector<vvp_net_t*>&last = layers[depth];
+
+      vector<bench_probe*> probes (width);
+      for (unsigned idx = 0 ; idx < width ; idx += 1) {
+	    vvp_net_t*net = new vvp_net_t;
+	    net->fun = probes[idx] = new bench_probe;
+	    last[idx]->link(vvp_net_ptr_t(net, 0));
+      }
+
+      if (schedule_levelize_flag)
+	    schedule_levelize();
+
+      bench_stimulus stim (inputs, steps);
+      schedule_generic(&stim, 0, false);
+
+      clock_t start = clock();
+      schedule_simulate();
+      double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+      unsigned long sum = 0;
+      for (unsigned idx = 0 ; idx < width ; idx += 1)
+	    sum = sum * 31 + probes[idx]->value;
+
+      printf("levelize=%d gates=%lu levels=%lu: %.3fs, %lu events,"
+	     " checksum %lx\n", schedule_levelize_flag? 1 : 0,
+	     (unsigned long)width * depth, count_levelize_levels, secs,
+	     count_gen_events, sum);
+      return 0;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2026 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Time the verinum operations that the compiler uses to fold constant
+ * expressions.
+ *
+ * Each pass works like the elaboration of a generate loop: a 32 bit
+ * signed genvar is compared against its limit and stepped, and
+ * parameter expressions (+, -, *, /, %, shifts, compares, ~) are
+ * folded from it. The same is then done with 64 and 128 bit unsigned
+ * values, and with 32 bit values that hold x bits, which take the
+ * bit-by-bit paths. Each group is timed on its own.
+ *
+ * The results of the last pass of each loop are folded into a checksum
+ * of their bits (the other passes only add the compares, so that the
+ * checksum does not dominate the time). The checksum only depends on
+ * the values, so it must be the same when the bench is linked with
+ * different verinum implementations.
+ *
+ * Build it in the top directory of a configured tree, after verinum.o
+ * has been built there (for example by "make"), and run it:
+ *
+ *    g++ -O2 -I. -o verinum_fold bench/verinum_fold.cc verinum.o
+ *    ./verinum_fold
+ *
+ * To compare two versions of verinum, build the bench against the
+ * verinum.o of each tree.
+ */
+
+# include  "config.h"
+# include  "verinum.h"
+# include  <cstdio>
+# include  <ctime>
+
+static unsigned long checksum = 0;
+
+static void sum_bits(const verinum&val)
+{
+      for (unsigned idx = 0 ; idx < val.len() ; idx += 1)
+	    checksum = checksum * 3 + val.get(idx);
+}
+
+static void sum_bit(verinum::V val)
+{
+      checksum = checksum * 3 + val;
+}
+
+/*
+ * Fold the expressions of one generate iteration over genvar i.
+ */
+static void fold_iteration(const verinum&i, const verinum&width,
+			   const verinum&one, const verinum&two, bool sum)
+{
+      verinum lsb = i * width;
+      verinum msb = lsb + width - one;
+      verinum half = i / two;
+      verinum odd = i % two;
+      verinum mask = (one << (unsigned)(i.as_ulong() % 31)) - one;
+      verinum inv = ~mask;
+      verinum neg = -msb;
+      verinum shr = msb >> 3;
+
+      if (sum) {
+	    sum_bits(msb);
+	    sum_bits(half);
+	    sum_bits(odd);
+	    sum_bits(inv);
+	    sum_bits(neg);
+	    sum_bits(shr);
+      }
+      sum_bit(lsb == msb);
+      sum_bit(half < odd);
+      sum_bit(mask <= inv);
+}
+
+/*
+ * Run a generate loop of count iterations with wid bit values.
+ */
+static double run_loop(unsigned wid, bool is_signed, unsigned count,
+		       unsigned passes, bool with_x)
+{
+      verinum one ((uint64_t)1, wid);
+      verinum two ((uint64_t)2, wid);
+      verinum width ((uint64_t)8, wid);
+      verinum step ((uint64_t)1, wid);
+      verinum limit ((uint64_t)count, wid);
+      one.has_sign(is_signed);
+      two.has_sign(is_signed);
+      width.has_sign(is_signed);
+      step.has_sign(is_signed);
+      limit.has_sign(is_signed);
+      if (with_x)
+	    width.set(wid-1, verinum::Vx);
+
+      clock_t start = clock();
+      for (unsigned pass = 0 ; pass < passes ; pass += 1) {
+	    verinum i ((uint64_t)0, wid);
+	    i.has_sign(is_signed);
+	    while ((i < limit) == verinum::V1) {
+		  fold_iteration(i, width, one, two, pass+1 == passes);
+		  i = i + step;
+	    }
+      }
+      return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char*argv[])
+{
+      (void)argc;
+      (void)argv;
+
+      double t32 = run_loop(32, true, 1000, 500, false);
+      double t64 = run_loop(64, false, 1000, 500, false);
+      double t128 = run_loop(128, false, 1000, 100, false);
+      double tx = run_loop(32, true, 1000, 100, true);
+
+      printf("32 bit signed:  %.3fs (500 x 1000 iterations)\n", t32);
+      printf("64 bit:         %.3fs (500 x 1000 iterations)\n", t64);
+      printf("128 bit:        %.3fs (100 x 1000 iterations)\n", t128);
+      printf("32 bit with x:  %.3fs (100 x 1000 iterations)\n", tx);
+      printf("checksum %lx\n", checksum);
+
+      return 0;
+}
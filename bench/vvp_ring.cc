@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2026 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Check and time the vvp_ring template that stores the queue classes
+ * of the vvp run time.
+ *
+ * The check drives a vvp_ring and a std::deque with the same mix of
+ * push, pop, erase and index operations and compares them after every
+ * step. It also walks the cases that are easy to get wrong: pushing
+ * at the front of an empty ring (the head wraps below 0), growing a
+ * ring whose contents wrap around the end of the buffer, and erasing
+ * from either half of a wrapped ring.
+ *
+ * The bench then times a FIFO (push_back/pop_front at a steady depth)
+ * and an indexed sweep over the same queue, for vvp_ring and for the
+ * std::deque that the queues used before.
+ *
+ * Build it in the vvp directory of a configured tree, so that config.h
+ * is found, and run it:
+ *
+ *    cd vvp
+ *    g++ -O2 -I. -I.. -o vvp_ring ../bench/vvp_ring.cc
+ *    ./vvp_ring
+ *
+ * The check prints the number of mismatches (there should be none)
+ * and the program exits with a non-zero status if there are any.
+ */
+
+# include  "vvp_darray.h"
+# include  <cstdio>
+# include  <cstdlib>
+# include  <ctime>
+# include  <deque>
+# include  <string>
+
+using namespace std;
+
+static unsigned errors = 0;
+
+template <class T> static void compare(const char*what, vvp_ring<T>&ring,
+				       const deque<T>&ref)
+{
+      if (ring.size() != ref.size()) {
+	    fprintf(stderr, "%s: size %zu, expected %zu\n", what,
+		    ring.size(), ref.size());
+	    errors += 1;
+	    return;
+      }
+      for (size_t idx = 0 ; idx < ref.size() ; idx += 1) {
+	    if (ring[idx] != ref[idx]) {
+		  fprintf(stderr, "%s: word %zu is wrong\n", what, idx);
+		  errors += 1;
+		  return;
+	    }
+      }
+}
+
+static string to_string_(unsigned val)
+{
+      char buf[16];
+      snprintf(buf, sizeof buf, "s%u", val);
+      return buf;
+}
+
+/*
+ * The corner cases, each checked against a std::deque.
+ */
+static void check_corners(void)
+{
+      { vvp_ring<int> ring;
+	deque<int> ref;
+	  // Push at the front of an empty ring, so the head wraps.
+	for (int idx = 0 ; idx < 5 ; idx += 1) {
+	      ring.push_front(idx);
+	      ref.push_front(idx);
+	}
+	compare("push_front wrap", ring, ref);
+      }
+
+      { vvp_ring<int> ring;
+	deque<int> ref;
+	  // Fill the first buffer, move the head along and refill it
+	  // so the contents wrap, then push one more to grow it.
+	for (int idx = 0 ; idx < 8 ; idx += 1) {
+	      ring.push_back(idx);
+	      ref.push_back(idx);
+	}
+	for (int idx = 0 ; idx < 5 ; idx += 1) {
+	      ring.pop_front();
+	      ref.pop_front();
+	}
+	for (int idx = 8 ; idx < 13 ; idx += 1) {
+	      ring.push_back(idx);
+	      ref.push_back(idx);
+	}
+	compare("wrapped", ring, ref);
+	ring.push_back(13);
+	ref.push_back(13);
+	compare("grow wrapped", ring, ref);
+	ring.push_front(-1);
+	ref.push_front(-1);
+	compare("push_front after grow", ring, ref);
+      }
+
+      { vvp_ring<string> ring;
+	deque<string> ref;
+	  // Erase from both halves of a wrapped ring.
+	for (unsigned idx = 0 ; idx < 6 ; idx += 1) {
+	      ring.push_back(to_string_(idx));
+	      ref.push_back(to_string_(idx));
+	}
+	for (unsigned idx = 0 ; idx < 4 ; idx += 1) {
+	      ring.pop_front();
+	      ref.pop_front();
+	}
+	for (unsigned idx = 6 ; idx < 12 ; idx += 1) {
+	      ring.push_back(to_string_(idx));
+	      ref.push_back(to_string_(idx));
+	}
+	compare("wrapped strings", ring, ref);
+	ring.erase(1);
+	ref.erase(ref.begin()+1);
+	compare("erase front half", ring, ref);
+	ring.erase(ring.size()-2);
+	ref.erase(ref.end()-2);
+	compare("erase back half", ring, ref);
+	ring.erase(0);
+	ref.erase(ref.begin());
+	ring.erase(ring.size()-1);
+	ref.erase(ref.end()-1);
+	compare("erase ends", ring, ref);
+      }
+}
+
+/*
+ * A random mix of all the operations. The queue grows and shrinks so
+ * the ring wraps and grows many times.
+ */
+static void check_random(void)
+{
+      vvp_ring<string> ring;
+      deque<string> ref;
+      srand(1);
+      for (unsigned step = 0 ; step < 1000000 ; step += 1) {
+	    unsigned op = rand() % 8;
+	    string val = to_string_(step);
+	    if (op < 2) {
+		  ring.push_back(val);
+		  ref.push_back(val);
+	    } else if (op < 4) {
+		  ring.push_front(val);
+		  ref.push_front(val);
+	    } else if (ref.empty()) {
+		  continue;
+	    } else if (op == 4) {
+		  ring.pop_back();
+		  ref.pop_back();
+	    } else if (op == 5) {
+		  ring.pop_front();
+		  ref.pop_front();
+	    } else if (op == 6) {
+		  size_t idx = rand() % ref.size();
+		  ring.erase(idx);
+		  ref.erase(ref.begin()+idx);
+	    } else {
+		  size_t idx = rand() % ref.size();
+		  ring[idx] = val;
+		  ref[idx] = val;
+	    }
+	    if (ring.size() != ref.size()
+		|| (! ref.empty() && (ring.front() != ref.front()
+				      || ring.back() != ref.back()))) {
+		  fprintf(stderr, "random: mismatch at step %u\n", step);
+		  errors += 1;
+		  return;
+	    }
+      }
+      compare("random", ring, ref);
+}
+
+/*
+ * Time a FIFO of the given depth (push at the back, pop at the front)
+ * and an indexed read of every word, repeated passes times.
+ */
+template <class Q> static double time_fifo(Q&queue, size_t depth,
+					   unsigned passes, double&sum)
+{
+      clock_t start = clock();
+      for (size_t idx = 0 ; idx < depth ; idx += 1)
+	    queue.push_back((double)idx);
+      for (unsigned pass = 0 ; pass < passes ; pass += 1) {
+	    for (size_t idx = 0 ; idx < depth ; idx += 1) {
+		  double val = queue.front();
+		  queue.pop_front();
+		  queue.push_back(val + 1.0);
+	    }
+	    for (size_t idx = 0 ; idx < queue.size() ; idx += 1)
+		  sum += queue[idx];
+      }
+      return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void bench(void)
+{
+      static const size_t depths[] = { 16, 1024, 65536 };
+      static const unsigned long total = 50000000;
+
+      for (unsigned idx = 0 ; idx < sizeof depths / sizeof depths[0] ; idx += 1) {
+	    size_t depth = depths[idx];
+	    unsigned passes = total / depth;
+	    double sum_ring = 0.0, sum_deque = 0.0;
+
+	    vvp_ring<double> ring;
+	    double t_ring = time_fifo(ring, depth, passes, sum_ring);
+	    deque<double> ref;
+	    double t_deque = time_fifo(ref, depth, passes, sum_deque);
+
+	    if (sum_ring != sum_deque)
+		  errors += 1;
+	    printf("depth %6zu: vvp_ring %.3fs, std::deque %.3fs\n",
+		   depth, t_ring, t_deque);
+      }
+}
+
+int main(int argc, char*argv[])
+{
+      (void)argc;
+      (void)argv;
+
+      check_corners();
+      check_random();
+      printf("check: %u errors\n", errors);
+      bench();
+
+      return errors? 1 : 0;
+}
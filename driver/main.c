@@ -1301,6 +1301,13 @@ int main(int argc, char **argv)
 	    }
       }
 
+	/* The verbose messages go to stdout, so they would be mixed
+	   into the output if that is written to stdout as well. */
+      if (verbose_flag && strcmp(opath, "-") == 0) {
+	    fprintf(stderr, "%s: -v cannot be used with -o -\n", argv[0]);
+	    return 1;
+      }
+
       if (vpi_dir == 0)
 	    vpi_dir = base;
       if (ivlpp_dir == 0)
@@ -57,6 +57,35 @@ static NetExpr* fix_assign_value(const NetNet*lhs, NetExpr*rhs)
       return rhs;
 }
 
+/*
+ * Make a key string that captures the values of the (already
+ * converted) arguments to a function call. If any of the arguments is
+ * not a constant, return false.
+ */
+static bool make_eval_cache_key(const vector<NetExpr*>&args, string&key)
+{
+      for (size_t idx = 0 ; idx < args.size() ; idx += 1) {
+	    if (const NetEConst*ce = dynamic_cast<const NetEConst*>(args[idx])) {
+		  const verinum&val = ce->value();
+		  key += val.has_sign()? 's' : 'u';
+		  key += val.is_string()? 't' : 'v';
+		  for (unsigned bit = 0 ; bit < val.len() ; bit += 1)
+			key += "01xz"[val.get(bit)];
+
+	    } else if (const NetECReal*re = dynamic_cast<const NetECReal*>(args[idx])) {
+		  double val = re->value().as_double();
+		  key += 'r';
+		  key.append(reinterpret_cast<const char*>(&val), sizeof val);
+
+	    } else {
+		  return false;
+	    }
+	    key += ',';
+      }
+
+      return true;
+}
+
 NetExpr* NetFuncDef::evaluate_function(const LineInfo&loc, const std::vector<NetExpr*>&args) const
 {
 	// Make the context map.
@@ -68,23 +97,47 @@ NetExpr* NetFuncDef::evaluate_function(const LineInfo&loc, const std::vector<Net
 		 << "Evaluate function " << scope()->basename() << endl;
       }
 
+	// Convert the arguments to the types of the input ports.
+      ivl_assert(loc, port_count() == args.size());
+      vector<NetExpr*> port_args (args.size());
+      for (size_t idx = 0 ; idx < port_count() ; idx += 1)
+	    port_args[idx] = fix_assign_value(port(idx), args[idx]);
+
+	// If this function has already been evaluated with the same
+	// argument values, then reuse the result.
+      string cache_key;
+      bool cache_flag = make_eval_cache_key(port_args, cache_key);
+      if (cache_flag) {
+	    map<string,NetExpr*>::const_iterator hit = eval_cache_.find(cache_key);
+	    if (hit != eval_cache_.end()) {
+		  for (size_t idx = 0 ; idx < port_args.size() ; idx += 1)
+			delete port_args[idx];
+
+		  NetExpr*res = hit->second->dup_expr();
+		  if (debug_eval_tree) {
+			cerr << loc.get_fileline() << ": NetFuncDef::evaluate_function: "
+			     << "Reuse previous result " << *res << endl;
+		  }
+		  return res;
+	    }
+      }
+
 	// Put the return value into the map...
       LocalVar&return_var = context_map[scope()->basename()];
       return_var.nwords = 0;
       return_var.value  = 0;
 
 	// Load the input ports into the map...
-      ivl_assert(loc, port_count() == args.size());
       for (size_t idx = 0 ; idx < port_count() ; idx += 1) {
 	    const NetNet*pnet = port(idx);
 	    perm_string aname = pnet->name();
 	    LocalVar&input_var = context_map[aname];
 	    input_var.nwords = 0;
-	    input_var.value  = fix_assign_value(pnet, args[idx]);
+	    input_var.value  = port_args[idx];
 
 	    if (debug_eval_tree) {
 		  cerr << loc.get_fileline() << ": NetFuncDef::evaluate_function: "
-		       << "   input " << aname << " = " << *args[idx] << endl;
+		       << "   input " << aname << " = " << *port_args[idx] << endl;
 	    }
       }
 
@@ -151,6 +204,8 @@ NetExpr* NetFuncDef::evaluate_function(const LineInfo&loc, const std::vector<Net
 		  else cerr << "<nil>";
 		  cerr << endl;
 	    }
+	    if (cache_flag && res)
+		  eval_cache_[cache_key] = res->dup_expr();
 	    return res;
       }
 
@@ -31,43 +31,53 @@
 
 void Nexus::connect(Link&r)
 {
+	// If this nexus has been merged into another, then connect to
+	// the nexus that absorbed it.
+      if (fwd_) {
+	    find_root_()->connect(r);
+	    return;
+      }
+
       Nexus*r_nexus = r.next_? r.find_nexus_() : 0;
       if (this == r_nexus)
 	    return;
 
-      delete[] name_;
-      name_ = 0;
+      invalidate_();
 
-	// Special case: This nexus is empty. Simply copy all the
-	// links of the other nexus to this one, and delete the old
-	// nexus.
+	// Special case: This nexus is empty. Simply take over all the
+	// links of the other nexus, and leave the old nexus behind
+	// as a forward pointer to this one.
       if (list_ == 0) {
 	    if (r.next_ == 0) {
 		  list_ = &r;
 		  r.next_ = &r;
+		  r.last_link_ = true;
 		  r.nexus_ = this;
+		  refs_ += 1;
 		  driven_ = NO_GUESS;
 	    } else {
 		  driven_ = r_nexus->driven_;
 		  list_ = r_nexus->list_;
-		  list_->nexus_ = this;
 		  r_nexus->list_ = 0;
-		  delete r_nexus;
+		  r_nexus->invalidate_();
+		  r_nexus->fwd_ = this;
+		  refs_ += 1;
 	    }
 	    return;
       }
 
 	// Special case: The Link is unconnected. Put it at the end of
-	// the current list and move the list_ pointer and nexus_ back
-	// pointer to suit.
+	// the current list and move the list_ pointer to suit.
       if (r.next_ == 0) {
 	    if (r.get_dir() != Link::INPUT)
 		  driven_ = NO_GUESS;
 
 	    r.nexus_ = this;
+	    refs_ += 1;
 	    r.next_ = list_->next_;
 	    list_->next_ = &r;
-	    list_->nexus_ = 0;
+	    list_->last_link_ = false;
+	    r.last_link_ = true;
 	    list_ = &r;
 	    return;
       }
@@ -76,16 +86,19 @@ void Nexus::connect(Link&r)
 	    driven_ = NO_GUESS;
 
 	// Splice the list of links from the "tmp" nexus to the end of
-	// this nexus. Adjust the nexus pointers as needed.
+	// this nexus. The links of the other nexus still point to it,
+	// so make it a forward pointer to this nexus instead of
+	// visiting all those links.
       Link*save_first = list_->next_;
       list_->next_ = r_nexus->list_->next_;
       r_nexus->list_->next_ = save_first;
-      list_->nexus_ = 0;
+      list_->last_link_ = false;
       list_ = r_nexus->list_;
-      list_->nexus_ = this;
 
       r_nexus->list_ = 0;
-      delete r_nexus;
+      r_nexus->invalidate_();
+      r_nexus->fwd_ = this;
+      refs_ += 1;
 }
 
 void connect(Link&l, Link&r)
@@ -109,7 +122,7 @@ void connect(Link&l, Link&r)
 
 Link::Link()
 : dir_(PASSIVE), drive0_(IVL_DR_STRONG), drive1_(IVL_DR_STRONG),
-  next_(0), nexus_(0)
+  last_link_(false), next_(0), nexus_(0)
 {
       node_ = 0;
       pin_zero_ = true;
@@ -118,21 +131,30 @@ Link::Link()
 Link::~Link()
 {
       if (next_) {
-	    Nexus*tmp = nexus();
+	    Nexus*tmp = find_nexus_();
 	    tmp->unlink(this);
 	    if (tmp->list_ == 0)
 		  delete tmp;
       }
 }
 
+/*
+ * Find the live nexus for this link. If the nexus_ pointer is stale
+ * (the nexus was merged into another) then point it directly at the
+ * live nexus so that the next lookup is immediate.
+ */
 Nexus* Link::find_nexus_() const
 {
-      assert(next_);
-      if (nexus_) return nexus_;
-      for (Link*cur = next_ ; cur != this ; cur = cur->next_) {
-	    if (cur->nexus_) return cur->nexus_;
-      }
-      return 0;
+      assert(next_ && nexus_);
+      if (nexus_->fwd_ == 0)
+	    return nexus_;
+
+      Nexus*root = nexus_->find_root_();
+      Nexus*old = nexus_;
+      nexus_ = root;
+      root->refs_ += 1;
+      old->release_();
+      return root;
 }
 
 Nexus* Link::nexus()
@@ -251,32 +273,104 @@ Nexus::Nexus(Link&that)
       name_ = 0;
       driven_ = NO_GUESS;
       t_cookie_ = 0;
+      fwd_ = 0;
+      refs_ = 0;
+      width_valid_ = false;
+      width_ = 0;
 
       if (that.next_ == 0) {
 	    list_ = &that;
 	    that.next_ = &that;
+	    that.last_link_ = true;
 	    that.nexus_ = this;
+	    refs_ += 1;
 	    driven_ = NO_GUESS;
 
       } else {
 	    Nexus*tmp = that.find_nexus_();
 	    list_ = tmp->list_;
-	    list_->nexus_ = this;
 	    driven_ = tmp->driven_;
 	    name_ = tmp->name_;
 
 	    tmp->list_ = 0;
 	    tmp->name_ = 0;
-	    delete tmp;
+	    tmp->fwd_ = this;
+	    refs_ += 1;
       }
 }
 
 Nexus::~Nexus()
 {
       assert(list_ == 0);
+      assert(refs_ == 0);
       delete[] name_;
 }
 
+/*
+ * Follow the forward pointers to the live nexus, and point all the
+ * nexus objects along the way directly at it. Any forwarding nexus
+ * that is no longer referenced by anything is deleted.
+ */
+Nexus* Nexus::find_root_()
+{
+      Nexus*root = this;
+      while (root->fwd_)
+	    root = root->fwd_;
+
+      Nexus*cur = this;
+      while (cur != root) {
+	    Nexus*up = cur->fwd_;
+	    if (up != root) {
+		  cur->fwd_ = root;
+		  root->refs_ += 1;
+		  assert(up->refs_ > 0);
+		  up->refs_ -= 1;
+	    }
+
+	    if (cur != this && cur->refs_ == 0) {
+		  root->refs_ -= 1;
+		  cur->fwd_ = 0;
+		  delete cur;
+	    }
+
+	    cur = up;
+      }
+
+      return root;
+}
+
+/*
+ * Drop a reference to this nexus. If this is a forwarding nexus that
+ * is no longer referenced, then delete it and release the reference
+ * that it holds on the nexus it forwards to.
+ */
+void Nexus::release_()
+{
+      Nexus*cur = this;
+      while (cur) {
+	    assert(cur->refs_ > 0);
+	    cur->refs_ -= 1;
+	    if (cur->refs_ > 0 || cur->fwd_ == 0)
+		  break;
+
+	    Nexus*up = cur->fwd_;
+	    cur->fwd_ = 0;
+	    delete cur;
+	    cur = up;
+      }
+}
+
+/*
+ * The set of links in the nexus has changed, so the cached results
+ * that depend on it are no longer valid.
+ */
+void Nexus::invalidate_()
+{
+      delete[] name_;
+      name_ = 0;
+      width_valid_ = false;
+}
+
 bool Nexus::assign_lval() const
 {
       for (const Link*cur = first_nlink() ; cur ; cur = cur->next_nlink()) {
@@ -385,10 +479,10 @@ void Nexus::drivers_drive(ivl_drive_t drive0, ivl_drive_t drive1)
 
 void Nexus::unlink(Link*that)
 {
-      delete[] name_;
-      name_ = 0;
+      invalidate_();
 
       assert(that);
+      assert(fwd_ == 0);
 
 	// Special case: the Link is the only link in the nexus. In
 	// this case, the unlink is trivial. Also clear the Nexus
@@ -400,6 +494,8 @@ void Nexus::unlink(Link*that)
 	    driven_ = NO_GUESS;
 	    that->nexus_ = 0;
 	    that->next_ = 0;
+	    that->last_link_ = false;
+	    release_();
 	    return;
       }
 
@@ -420,13 +516,18 @@ void Nexus::unlink(Link*that)
 	// If "that" was the last item in the list, then change the
 	// list_ pointer to point to the new end of the list.
       if (list_ == that) {
-	    assert(that->nexus_ == this);
+	    assert(that->last_link_);
 	    list_ = prev;
-	    list_->nexus_ = this;
+	    list_->last_link_ = true;
       }
 
+	// The caller has already made the nexus_ pointer of "that"
+	// point directly to this nexus.
+      assert(that->nexus_ == this);
       that->nexus_ = 0;
       that->next_ = 0;
+      that->last_link_ = false;
+      release_();
 }
 
 Link* Nexus::first_nlink()
@@ -443,31 +544,31 @@ const Link* Nexus::first_nlink() const
 
 /*
  * The t_cookie can be set exactly once. This attaches an ivl_nexus_t
- * object to the Nexus, and causes the Link list to be marked up for
- * efficient use by the code generator. The change is to give all the
- * links a valid nexus_ pointer. This breaks most of the other
- * methods, but they are not used during code generation.
-*/
+ * object to the Nexus for use by the code generator.
+ */
 void Nexus::t_cookie(ivl_nexus_t val) const
 {
       assert(val && !t_cookie_);
       t_cookie_ = val;
-
-      for (Link*cur = list_->next_ ; cur->nexus_ == 0 ; cur = cur->next_)
-	    cur->nexus_ = const_cast<Nexus*> (this);
 }
 
 unsigned Nexus::vector_width() const
 {
+      if (width_valid_)
+	    return width_;
+
+      width_ = 0;
       for (const Link*cur = first_nlink() ; cur ; cur = cur->next_nlink()) {
 	    const NetNet*sig = dynamic_cast<const NetNet*>(cur->get_obj());
 	    if (sig == 0)
 		  continue;
 
-	    return sig->vector_width();
+	    width_ = sig->vector_width();
+	    break;
       }
 
-      return 0;
+      width_valid_ = true;
+      return width_;
 }
 
 NetNet* Nexus::pick_any_net()
@@ -184,6 +184,8 @@ class Link {
       DIR dir_           : 2;
       ivl_drive_t drive0_ : 3;
       ivl_drive_t drive1_ : 3;
+	// This is true for the last Link in the nexus list.
+      bool last_link_    : 1;
 
     private:
       Nexus* find_nexus_() const;
@@ -191,9 +193,11 @@ class Link {
     private:
 	// The Nexus uses these to maintain its list of Link
 	// objects. If this link is not connected to anything,
-	// then these pointers are both nil.
+	// then these pointers are both nil. The nexus_ may point
+	// to a Nexus that has since been merged into another, and
+	// find_nexus_() shortens that path as it goes.
       Link *next_;
-      Nexus*nexus_;
+      mutable Nexus*nexus_;
 
     private: // not implemented
       Link(const Link&);
@@ -342,15 +346,22 @@ class NetBranch  : public NetPins, public IslandBranch {
  * The links in a nexus are grouped into a circularly linked list,
  * with the nexus pointing to the last Link. Each link in turn points
  * to the next link in the nexus, with the last link pointing back to
- * the first. The last link also has a non-nil nexus_ pointer back to
- * this nexus.
+ * the first. The last link is also marked with the last_link_ flag.
+ *
+ * The nexus objects form a union-find forest. Every connected link
+ * has a nexus_ pointer, but when two nexus objects are merged, the
+ * absorbed nexus is not deleted. Instead it is left behind as a
+ * forwarding pointer (fwd_) to the surviving nexus, so the merge does
+ * not need to touch the links of the absorbed nexus. Lookups through
+ * a link follow the forwarding pointers and compress the path. The
+ * refs_ count is the number of links and nexus objects that point to
+ * this nexus, and a forwarding nexus is deleted when that reaches 0.
  *
  * The t_cookie() is an ivl_nexus_t that the code generator uses to
  * store data in the nexus. When a Nexus is created, this cookie is
  * set to nil. The code generator may set the cookie once. This locks
- * the nexus, and rewrites the Link list to be optimal for the code
- * generator. In the process, *all* of the other methods are no longer
- * functional.
+ * the nexus, and the code generator may not change the links after
+ * that.
  */
 class Nexus {
 
@@ -423,9 +434,21 @@ class Nexus {
       Link*list_;
       void unlink(Link*);
 
+	// Union-find support. The fwd_ pointer is nil for a live
+	// nexus, and points to the absorbing nexus otherwise.
+      Nexus*fwd_;
+      unsigned refs_;
+      Nexus* find_root_();
+      void release_();
+      void invalidate_();
+
       mutable char* name_; /* Cache the calculated name for the Nexus. */
       mutable ivl_nexus_t t_cookie_;
 
+	/* Cache the vector width of the Nexus. */
+      mutable bool width_valid_;
+      mutable unsigned width_;
+
       enum VALUE { NO_GUESS, V0, V1, Vx, Vz, VAR };
       mutable VALUE driven_;
 
@@ -3679,6 +3702,12 @@ class NetFuncDef : public NetBaseDef {
 
     private:
       NetNet*result_sig_;
+
+	// Constant functions have no side effects, so the results of
+	// successful evaluations are kept, keyed by the argument
+	// values, and reused when the function is called again with
+	// the same arguments.
+      mutable std::map<std::string,NetExpr*> eval_cache_;
 };
 
 /*
@@ -5177,18 +5206,17 @@ inline __ObjectPathManip scope_path(const NetObj*obj)
 extern ostream& operator << (ostream&o, __ObjectPathManip);
 
 /*
- * If this link has a nexus_ pointer, then it is the last Link in the
- * list. next_nlink() returns 0 for the last Link.
+ * next_nlink() returns 0 for the last Link in the list.
  */
 inline Link* Link::next_nlink()
 {
-      if (nexus_) return 0;
+      if (last_link_) return 0;
       else return next_;
 }
 
 inline const Link* Link::next_nlink() const
 {
-      if (nexus_) return 0;
+      if (last_link_) return 0;
       else return next_;
 }
 
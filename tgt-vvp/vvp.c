@@ -50,6 +50,9 @@ unsigned show_file_line = 0;
 
 int debug_draw = 0;
 
+/* Size of the stdio buffer used for the generated output. */
+# define VVP_OUT_BUFFER_SIZE (256*1024)
+
 /* This needs to match the actual flag count in the VVP thread. */
 # define FLAGS_COUNT 512
 
@@ -65,7 +68,8 @@ __inline__ static void draw_execute_header(ivl_design_t des)
 		  extra_args = "";
 	    fprintf(vvp_out, "#! %s%s\n", cp, extra_args);
 #if !defined(__MINGW32__)
-	    fchmod(fileno(vvp_out), 0755);
+	    if (vvp_out != stdout)
+		  fchmod(fileno(vvp_out), 0755);
 #endif
       }
       fprintf(vvp_out, ":ivl_version \"" VERSION "\"");
@@ -194,14 +198,27 @@ int target_design(ivl_design_t des)
             show_file_line = fl_value > 0;
       }
 
+	/* An output path of "-" sends the generated code to stdout,
+	   so that it can be piped directly into vvp without an
+	   intermediate file. */
+      if (strcmp(path, "-") == 0) {
+	    vvp_out = stdout;
+      } else {
 #ifdef HAVE_FOPEN64
-      vvp_out = fopen64(path, "w");
+	    vvp_out = fopen64(path, "w");
 #else
-      vvp_out = fopen(path, "w");
+	    vvp_out = fopen(path, "w");
 #endif
-      if (vvp_out == 0) {
-	    perror(path);
-	    return -1;
+	    if (vvp_out == 0) {
+		  perror(path);
+		  return -1;
+	    }
+	      /* The output is written in many small pieces, so give
+		 the file a large buffer to keep the number of writes
+		 down. This must be done before any I/O on the stream,
+		 so it is not done for stdout, which ivl may have
+		 already written to. */
+	    setvbuf(vvp_out, 0, _IOFBF, VVP_OUT_BUFFER_SIZE);
       }
 
       vvp_errors = 0;
@@ -240,7 +257,10 @@ int target_design(ivl_design_t des)
 	    fprintf(vvp_out, "    \"%s\";\n", ivl_file_table_item(idx));
       }
 
-      fclose(vvp_out);
+      if (vvp_out == stdout)
+	    fflush(vvp_out);
+      else
+	    fclose(vvp_out);
       EOC_cleanup_drivers();
 
       return rc + vvp_errors;
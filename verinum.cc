@@ -44,18 +44,78 @@ extern "C" long int lround(double x)
 
 static verinum::V add_with_carry(verinum::V l, verinum::V r, verinum::V&c);
 
+inline verinum::V verinum::get_bit_(unsigned idx) const
+{
+      unsigned wdx = idx / 64;
+      unsigned sh = idx % 64;
+      uint64_t abit = (bits_[wdx] >> sh) & 1;
+      uint64_t bbit = (bits_[nwords_() + wdx] >> sh) & 1;
+      return (V) (abit | (bbit << 1));
+}
+
+inline void verinum::set_bit_(unsigned idx, V val)
+{
+      unsigned wdx = idx / 64;
+      uint64_t mask = (uint64_t)1 << (idx % 64);
+      uint64_t*abits = bits_ + wdx;
+      uint64_t*bbits = bits_ + nwords_() + wdx;
+      if (val & 1) *abits |= mask;
+      else *abits &= ~mask;
+      if (val & 2) *bbits |= mask;
+      else *bbits &= ~mask;
+}
+
+/*
+ * Allocate the storage for nbits bits. All the bits are set to V0.
+ */
+void verinum::alloc_bits_(unsigned nbits)
+{
+      nbits_ = nbits;
+      unsigned nwords = nwords_();
+      if (nwords <= 1) {
+	    bits_ = local_bits_;
+	    local_bits_[0] = 0;
+	    local_bits_[1] = 0;
+      } else {
+	    bits_ = new uint64_t[2*nwords];
+	    for (unsigned idx = 0 ;  idx < 2*nwords ;  idx += 1)
+		  bits_[idx] = 0;
+      }
+}
+
+/*
+ * Copy the a plane of a defined value into the dst array, extending it
+ * to nwords words. The value is sign extended if it is signed.
+ */
+void verinum::extend_words_(uint64_t*dst, unsigned nwords) const
+{
+      unsigned my_nwords = nwords_();
+      assert(my_nwords <= nwords);
+      for (unsigned idx = 0 ;  idx < my_nwords ;  idx += 1)
+	    dst[idx] = bits_[idx];
+
+      uint64_t pad = 0;
+      if (has_sign_ && nbits_ > 0 && get_bit_(nbits_-1) == V1) {
+	    pad = ~(uint64_t)0;
+	    if (nbits_ % 64)
+		  dst[my_nwords-1] |= pad << (nbits_ % 64);
+      }
+      for (unsigned idx = my_nwords ;  idx < nwords ;  idx += 1)
+	    dst[idx] = pad;
+}
+
 verinum::verinum()
-: bits_(0), nbits_(0), has_len_(false), has_sign_(false), is_single_(false), string_flag_(false)
+: has_len_(false), has_sign_(false), is_single_(false), string_flag_(false)
 {
+      alloc_bits_(0);
 }
 
 verinum::verinum(const V*bits, unsigned nbits, bool has_len__)
 : has_len_(has_len__), has_sign_(false), is_single_(false), string_flag_(false)
 {
-      nbits_ = nbits;
-      bits_ = new V [nbits];
+      alloc_bits_(nbits);
       for (unsigned idx = 0 ;  idx < nbits ;  idx += 1) {
-	    bits_[idx] = bits[idx];
+	    set_bit_(idx, bits[idx]);
       }
 }
 
@@ -116,58 +176,58 @@ verinum::verinum(const string&s)
 : has_len_(true), has_sign_(false), is_single_(false), string_flag_(true)
 {
       string str = process_verilog_string_quotes(s);
-      nbits_ = str.length() * 8;
 
 	// Special case: The string "" is 8 bits of 0.
-      if (nbits_ == 0) {
-	    nbits_ = 8;
-	    bits_ = new V [nbits_];
-	    bits_[0] = V0;
-	    bits_[1] = V0;
-	    bits_[2] = V0;
-	    bits_[3] = V0;
-	    bits_[4] = V0;
-	    bits_[5] = V0;
-	    bits_[6] = V0;
-	    bits_[7] = V0;
+      if (str.length() == 0) {
+	    alloc_bits_(8);
 	    return;
       }
 
-      bits_ = new V [nbits_];
+      alloc_bits_(str.length() * 8);
 
+	// The first character of the string is the most significant
+	// byte of the value.
       unsigned idx, cp;
-      V*bp = bits_+nbits_;
       for (idx = nbits_, cp = 0 ;  idx > 0 ;  idx -= 8, cp += 1) {
-	    char ch = str[cp];
-	    *(--bp) = (ch&0x80) ? V1 : V0;
-	    *(--bp) = (ch&0x40) ? V1 : V0;
-	    *(--bp) = (ch&0x20) ? V1 : V0;
-	    *(--bp) = (ch&0x10) ? V1 : V0;
-	    *(--bp) = (ch&0x08) ? V1 : V0;
-	    *(--bp) = (ch&0x04) ? V1 : V0;
-	    *(--bp) = (ch&0x02) ? V1 : V0;
-	    *(--bp) = (ch&0x01) ? V1 : V0;
+	    unsigned char ch = str[cp];
+	    unsigned bit = idx - 8;
+	    bits_[bit / 64] |= (uint64_t)ch << (bit % 64);
       }
 }
 
 verinum::verinum(verinum::V val, unsigned n, bool h)
 : has_len_(h), has_sign_(false), is_single_(false), string_flag_(false)
 {
-      nbits_ = n;
-      bits_ = new V[nbits_];
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1)
-	    bits_[idx] = val;
+      alloc_bits_(n);
+      unsigned nwords = nwords_();
+      if (nwords == 0)
+	    return;
+
+      uint64_t aword = (val & 1)? ~(uint64_t)0 : 0;
+      uint64_t bword = (val & 2)? ~(uint64_t)0 : 0;
+      for (unsigned idx = 0 ;  idx < nwords ;  idx += 1) {
+	    bits_[idx] = aword;
+	    bits_[nwords+idx] = bword;
+      }
+
+	// Keep the unused bits of the top word clear.
+      if (nbits_ % 64) {
+	    uint64_t mask = ((uint64_t)1 << (nbits_ % 64)) - 1;
+	    bits_[nwords-1] &= mask;
+	    bits_[2*nwords-1] &= mask;
+      }
 }
 
 verinum::verinum(uint64_t val, unsigned n)
 : has_len_(true), has_sign_(false), is_single_(false), string_flag_(false)
 {
-      nbits_ = n;
-      bits_ = new V[nbits_];
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1) {
-	    bits_[idx] = (val&1) ? V1 : V0;
-	    val >>= (uint64_t)1;
-      }
+      alloc_bits_(n);
+      if (n == 0)
+	    return;
+
+      if (n < 64)
+	    val &= ((uint64_t)1 << n) - 1;
+      bits_[0] = val;
 }
 
 /* The second argument is not used! It is there to make this
@@ -182,9 +242,8 @@ verinum::verinum(double val, bool)
 
 	/* We return `bx for a NaN or +/- infinity. */
       if (val != val || (val && (val == 0.5*val))) {
-	    nbits_ = 1;
-	    bits_ = new V[nbits_];
-	    bits_[0] = Vx;
+	    alloc_bits_(1);
+	    set_bit_(0, Vx);
 	    return;
       }
 
@@ -200,15 +259,14 @@ verinum::verinum(double val, bool)
 
 	/* Get the exponent and fractional part of the number. */
       fraction = frexp(val, &exponent);
-      nbits_ = exponent+1;
-      bits_ = new V[nbits_];
+      alloc_bits_(exponent+1);
 
 	/* If the value is small enough just use lround(). */
       if (nbits_ <= BITS_IN_LONG) {
 	    long sval = lround(val);
 	    if (is_neg) sval = -sval;
 	    for (unsigned idx = 0; idx < nbits_; idx += 1) {
-		  bits_[idx] = (sval&1) ? V1 : V0;
+		  set_bit_(idx, (sval&1) ? V1 : V0);
 		  sval >>= 1;
 	    }
 	      /* Trim the result. */
@@ -224,7 +282,7 @@ verinum::verinum(double val, bool)
 	    unsigned long bits = (unsigned long) fraction;
 	    fraction = fraction - (double) bits;
 	    for (unsigned idx = 0; idx < nbits_; idx += 1) {
-		  bits_[idx] = (bits&1) ? V1 : V0;
+		  set_bit_(idx, (bits&1) ? V1 : V0);
 		  bits >>= 1;
 	    }
       } else {
@@ -234,7 +292,7 @@ verinum::verinum(double val, bool)
 		  unsigned max_idx = (wd+1)*BITS_IN_LONG;
 		  if (max_idx > nbits_) max_idx = nbits_;
 		  for (unsigned idx = wd*BITS_IN_LONG; idx < max_idx; idx += 1) {
-			bits_[idx] = (bits&1) ? V1 : V0;
+			set_bit_(idx, (bits&1) ? V1 : V0);
 			bits >>= 1;
 		  }
 		  fraction = ldexp(fraction, BITS_IN_LONG);
@@ -257,43 +315,38 @@ void verinum::signed_trim()
 {
 	/* Do we have any extra digits? */
       unsigned tlen = nbits_-1;
-      verinum::V sign = bits_[tlen];
-      while ((tlen > 0) && (bits_[tlen] == sign)) tlen -= 1;
+      verinum::V sign = get_bit_(tlen);
+      while ((tlen > 0) && (get_bit_(tlen) == sign)) tlen -= 1;
 
 	/* tlen now points to the first digit that is not the sign.
 	 * or bit 0. Set the length to include this bit and one proper
 	 * sign bit if needed. */
-      if (bits_[tlen] != sign) tlen += 1;
+      if (get_bit_(tlen) != sign) tlen += 1;
       tlen += 1;
 
 	/* Trim the bits if needed. */
       if (tlen < nbits_) {
-	    V* tbits = new V[tlen];
-	    for (unsigned idx = 0; idx < tlen; idx += 1)
-		  tbits[idx] = bits_[idx];
-	    delete[] bits_;
-	    bits_ = tbits;
-	    nbits_ = tlen;
+	    verinum tmp (*this, tlen);
+	    tmp.has_len_ = has_len_;
+	    *this = tmp;
       }
 }
 
 verinum::verinum(const verinum&that)
 {
       string_flag_ = that.string_flag_;
-      nbits_ = that.nbits_;
-      bits_ = new V[nbits_];
       has_len_ = that.has_len_;
       has_sign_ = that.has_sign_;
       is_single_ = that.is_single_;
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1)
+      alloc_bits_(that.nbits_);
+      for (unsigned idx = 0 ;  idx < 2*nwords_() ;  idx += 1)
 	    bits_[idx] = that.bits_[idx];
 }
 
 verinum::verinum(const verinum&that, unsigned nbits)
 {
       string_flag_ = that.string_flag_ && (that.nbits_ == nbits);
-      nbits_ = nbits;
-      bits_ = new V[nbits_];
+      alloc_bits_(nbits);
       has_len_ = true;
       has_sign_ = that.has_sign_;
       is_single_ = false;
@@ -301,16 +354,27 @@ verinum::verinum(const verinum&that, unsigned nbits)
       unsigned copy = nbits;
       if (copy > that.nbits_)
 	    copy = that.nbits_;
-      for (unsigned idx = 0 ;  idx < copy ;  idx += 1)
+
+	// Copy whole words, then clear any bits past the copied part
+	// in the last word that was copied.
+      unsigned nwords = nwords_();
+      unsigned that_nwords = that.nwords_();
+      unsigned cwords = (copy + 63) / 64;
+      for (unsigned idx = 0 ;  idx < cwords ;  idx += 1) {
 	    bits_[idx] = that.bits_[idx];
+	    bits_[nwords+idx] = that.bits_[that_nwords+idx];
+      }
+      if (copy % 64) {
+	    uint64_t mask = ((uint64_t)1 << (copy % 64)) - 1;
+	    bits_[cwords-1] &= mask;
+	    bits_[nwords+cwords-1] &= mask;
+      }
 
       if (copy < nbits_) {
 	    if (has_sign_ || that.is_single_) {
+		  V pad = copy > 0? get_bit_(copy-1) : V0;
 		  for (unsigned idx = copy ;  idx < nbits_ ;  idx += 1)
-			bits_[idx] = bits_[idx-1];
-	    } else {
-		  for (unsigned idx = copy ;  idx < nbits_ ;  idx += 1)
-			bits_[idx] = verinum::V0;
+			set_bit_(idx, pad);
 	    }
       }
 }
@@ -322,35 +386,37 @@ verinum::verinum(int64_t that)
 
       if (that < 0) tmp = (that+1)/2;
       else tmp = that/2;
-      nbits_ = 1;
+      unsigned nbits = 1;
       while (tmp != 0) {
-	    nbits_ += 1;
+	    nbits += 1;
 	    tmp /= 2;
       }
 
-      nbits_ += 1;
+      nbits += 1;
 
-      bits_ = new V[nbits_];
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1) {
-	    bits_[idx] = (that & 1)? V1 : V0;
-	    that >>= 1;
-      }
+      alloc_bits_(nbits);
+      uint64_t val = that;
+      if (nbits < 64)
+	    val &= ((uint64_t)1 << nbits) - 1;
+      bits_[0] = val;
 }
 
 verinum::~verinum()
 {
-      delete[]bits_;
+      if (bits_ != local_bits_)
+	    delete[]bits_;
 }
 
 verinum& verinum::operator= (const verinum&that)
 {
       if (this == &that) return *this;
-      if (nbits_ != that.nbits_) {
-            delete[]bits_;
-            nbits_ = that.nbits_;
-            bits_ = new V[that.nbits_];
+      if (nwords_() != that.nwords_()) {
+	    if (bits_ != local_bits_)
+		  delete[]bits_;
+	    alloc_bits_(that.nbits_);
       }
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1)
+      nbits_ = that.nbits_;
+      for (unsigned idx = 0 ;  idx < 2*nwords_() ;  idx += 1)
 	    bits_[idx] = that.bits_[idx];
 
       has_len_ = that.has_len_;
@@ -363,56 +429,37 @@ verinum& verinum::operator= (const verinum&that)
 verinum::V verinum::get(unsigned idx) const
 {
       assert(idx < nbits_);
-      return bits_[idx];
+      return get_bit_(idx);
 }
 
 verinum::V verinum::set(unsigned idx, verinum::V val)
 {
       assert(idx < nbits_);
-      return bits_[idx] = val;
+      set_bit_(idx, val);
+      return val;
 }
 
 void verinum::set(unsigned off, const verinum&val)
 {
       assert(off + val.len() <= nbits_);
       for (unsigned idx = 0 ; idx < val.len() ; idx += 1)
-	    bits_[off+idx] = val[idx];
+	    set_bit_(off+idx, val.get_bit_(idx));
 }
 
 unsigned verinum::as_unsigned() const
 {
-      if (nbits_ == 0)
-	    return 0;
-
-      if (!is_defined())
-	    return 0;
-
-      unsigned val = 0;
-      unsigned mask = 1;
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1, mask <<= 1)
-	    if (bits_[idx] == V1) {
-		  if (mask == 0) return ~mask;
-		  val |= mask;
-	    }
+      uint64_t val = as_ulong64();
+      if (val > UINT_MAX)
+	    return UINT_MAX;
 
       return val;
 }
 
 unsigned long verinum::as_ulong() const
 {
-      if (nbits_ == 0)
-	    return 0;
-
-      if (!is_defined())
-	    return 0;
-
-      unsigned long val = 0;
-      unsigned long mask = 1;
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1, mask <<= 1)
-	    if (bits_[idx] == V1) {
-		  if (mask == 0) return ~mask;
-		  val |= mask;
-	    }
+      uint64_t val = as_ulong64();
+      if (val > ULONG_MAX)
+	    return ULONG_MAX;
 
       return val;
 }
@@ -425,15 +472,13 @@ uint64_t verinum::as_ulong64() const
       if (!is_defined())
 	    return 0;
 
-      uint64_t val = 0;
-      uint64_t mask = 1;
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1, mask <<= 1)
-	    if (bits_[idx] == V1) {
-		  if (mask == 0) return ~mask;
-		  val |= mask;
-	    }
+	// If any bits above the first word are set, then the value
+	// is too large, so return the maximum value.
+      unsigned nwords = nwords_();
+      for (unsigned idx = 1 ;  idx < nwords ;  idx += 1)
+	    if (bits_[idx] != 0) return ~(uint64_t)0;
 
-      return val;
+      return bits_[0];
 }
 
 /*
@@ -466,26 +511,26 @@ signed long verinum::as_long() const
       }
       int lost_bits=0;
 
-      if (has_sign_ && (bits_[nbits_-1] == V1)) {
+      if (has_sign_ && (get_bit_(nbits_-1) == V1)) {
 	    val = -1;
 	    signed long mask = ~1L;
 	    for (unsigned idx = 0 ;  idx < top ;  idx += 1) {
-		  if (bits_[idx] == V0) val &= mask;
+		  if (get_bit_(idx) == V0) val &= mask;
 		  mask = (mask << 1) | 1L;
 	    }
 	    if (diag_top) {
 		  for (unsigned idx = top; idx < diag_top; idx += 1) {
-			if (bits_[idx] == V0) lost_bits=1;
+			if (get_bit_(idx) == V0) lost_bits=1;
 		  }
 	    }
       } else {
 	    signed long mask = 1;
 	    for (unsigned idx = 0 ;  idx < top ;  idx += 1, mask <<= 1) {
-		  if (bits_[idx] == V1) val |= mask;
+		  if (get_bit_(idx) == V1) val |= mask;
 	    }
 	    if (diag_top) {
 		  for (unsigned idx = top; idx < diag_top; idx += 1) {
-			if (bits_[idx] == V1) lost_bits=1;
+			if (get_bit_(idx) == V1) lost_bits=1;
 		  }
 	    }
       }
@@ -502,17 +547,17 @@ double verinum::as_double() const
 
       double val = 0.0;
         /* Do we have/want a signed value? */
-      if (has_sign_ && bits_[nbits_-1] == V1) {
+      if (has_sign_ && get_bit_(nbits_-1) == V1) {
 	    V carry = V1;
 	    for (unsigned idx = 0; idx < nbits_; idx += 1) {
-		  V sum = add_with_carry(~bits_[idx], V0, carry);
+		  V sum = add_with_carry(~get_bit_(idx), V0, carry);
 		  if (sum == V1)
 			val += pow(2.0, (double)idx);
 	    }
 	    val *= -1.0;
       } else {
 	    for (unsigned idx = 0; idx < nbits_; idx += 1) {
-		  if (bits_[idx] == V1)
+		  if (get_bit_(idx) == V1)
 			val += pow(2.0, (double)idx);
 	    }
       }
@@ -527,17 +572,9 @@ string verinum::as_string() const
 
       string res;
       for (unsigned idx = nbits_ ;  idx > 0 ;  idx -= 8) {
-	    char char_val = 0;
-	    V*bp = bits_+idx;
-
-	    if (*(--bp) == V1) char_val |= 0x80;
-	    if (*(--bp) == V1) char_val |= 0x40;
-	    if (*(--bp) == V1) char_val |= 0x20;
-	    if (*(--bp) == V1) char_val |= 0x10;
-	    if (*(--bp) == V1) char_val |= 0x08;
-	    if (*(--bp) == V1) char_val |= 0x04;
-	    if (*(--bp) == V1) char_val |= 0x02;
-	    if (*(--bp) == V1) char_val |= 0x01;
+	    unsigned bit = idx - 8;
+	    uint64_t abits = bits_[bit / 64] & ~bits_[nwords_() + bit / 64];
+	    char char_val = (abits >> (bit % 64)) & 0xff;
 
 	    if (char_val == '"' || char_val == '\\') {
 		  char tmp[5];
@@ -560,32 +597,34 @@ bool verinum::is_before(const verinum&that) const
       if (that.nbits_ < nbits_) return false;
 
       for (unsigned idx = nbits_  ;  idx > 0 ;  idx -= 1) {
-	    if (bits_[idx-1] < that.bits_[idx-1]) return true;
-	    if (bits_[idx-1] > that.bits_[idx-1]) return false;
+	    V lbit = get_bit_(idx-1);
+	    V rbit = that.get_bit_(idx-1);
+	    if (lbit < rbit) return true;
+	    if (lbit > rbit) return false;
       }
       return false;
 }
 
 bool verinum::is_defined() const
 {
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1) {
-	    if (bits_[idx] == Vx) return false;
-	    if (bits_[idx] == Vz) return false;
+      unsigned nwords = nwords_();
+      for (unsigned idx = 0 ;  idx < nwords ;  idx += 1) {
+	    if (bits_[nwords+idx] != 0) return false;
       }
       return true;
 }
 
 bool verinum::is_zero() const
 {
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1)
-	    if (bits_[idx] != V0) return false;
+      for (unsigned idx = 0 ;  idx < 2*nwords_() ;  idx += 1)
+	    if (bits_[idx] != 0) return false;
 
       return true;
 }
 
 bool verinum::is_negative() const
 {
-      return (bits_[nbits_-1] == V1) && has_sign();
+      return (get_bit_(nbits_-1) == V1) && has_sign();
 }
 
 unsigned verinum::significant_bits() const
@@ -593,11 +632,11 @@ unsigned verinum::significant_bits() const
       unsigned sbits = nbits_;
 
       if (has_sign_) {
-	    V sign_bit = bits_[sbits-1];
-	    while ((sbits > 1) && (bits_[sbits-2] == sign_bit))
+	    V sign_bit = get_bit_(sbits-1);
+	    while ((sbits > 1) && (get_bit_(sbits-2) == sign_bit))
 		  sbits -= 1;
       } else {
-	    while ((sbits > 1) && (bits_[sbits-1] == verinum::V0))
+	    while ((sbits > 1) && (get_bit_(sbits-1) == verinum::V0))
 		  sbits -= 1;
       }
       return sbits;
@@ -605,9 +644,12 @@ unsigned verinum::significant_bits() const
 
 void verinum::cast_to_int2()
 {
-      for (unsigned idx = 0 ;  idx < nbits_ ;  idx += 1) {
-	    if (bits_[idx] == Vx || bits_[idx] == Vz)
-		  bits_[idx] = V0;
+	// Vx and Vz both become V0, so clear both planes wherever
+	// the b plane is set.
+      unsigned nwords = nwords_();
+      for (unsigned idx = 0 ;  idx < nwords ;  idx += 1) {
+	    bits_[idx] &= ~bits_[nwords+idx];
+	    bits_[nwords+idx] = 0;
       }
 }
 
@@ -824,8 +866,52 @@ ostream& operator<< (ostream&o, const verinum&v)
       return o;
 }
 
+/*
+ * Values that are fully defined and fit in a single 64-bit word can
+ * be handled by native integer arithmetic. These functions support
+ * the fast paths in the operators below.
+ */
+static inline bool fits_word(const verinum&val)
+{
+      return (val.len() > 0) && (val.len() <= 64) && val.is_defined();
+}
+
+static inline uint64_t word_mask(unsigned len)
+{
+      return (len >= 64)? ~(uint64_t)0 : ((uint64_t)1 << len) - 1;
+}
+
+/*
+ * Return the value extended to 64 bits. The value is sign extended if
+ * it is signed, and zero extended otherwise.
+ */
+static inline uint64_t word_value(const verinum&val)
+{
+      uint64_t tmp = val.as_ulong64();
+      unsigned len = val.len();
+      if (val.has_sign() && (len < 64) && ((tmp >> (len-1)) & 1))
+	    tmp |= ~word_mask(len);
+      return tmp;
+}
+
+static inline verinum word_result(uint64_t val, unsigned len,
+				  bool has_len_flag, bool signed_flag)
+{
+      verinum result (val, len);
+      result.has_len(has_len_flag);
+      result.has_sign(signed_flag);
+      return result;
+}
+
 verinum::V operator == (const verinum&left, const verinum&right)
 {
+      if (fits_word(left) && fits_word(right)) {
+	    bool signed_calc = left.has_sign() && right.has_sign();
+	    uint64_t lval = signed_calc? word_value(left) : left.as_ulong64();
+	    uint64_t rval = signed_calc? word_value(right) : right.as_ulong64();
+	    return (lval == rval)? verinum::V1 : verinum::V0;
+      }
+
       verinum::V left_pad = verinum::V0;
       verinum::V right_pad = verinum::V0;
       if (left.has_sign() && right.has_sign()) {
@@ -854,6 +940,15 @@ verinum::V operator == (const verinum&left, const verinum&right)
 
 verinum::V operator <= (const verinum&left, const verinum&right)
 {
+      if (fits_word(left) && fits_word(right)) {
+	    bool flag;
+	    if (left.has_sign() && right.has_sign())
+		  flag = (int64_t)word_value(left) <= (int64_t)word_value(right);
+	    else
+		  flag = left.as_ulong64() <= right.as_ulong64();
+	    return flag? verinum::V1 : verinum::V0;
+      }
+
       verinum::V left_pad = verinum::V0;
       verinum::V right_pad = verinum::V0;
       bool signed_calc = left.has_sign() && right.has_sign();
@@ -906,6 +1001,15 @@ verinum::V operator <= (const verinum&left, const verinum&right)
 
 verinum::V operator < (const verinum&left, const verinum&right)
 {
+      if (fits_word(left) && fits_word(right)) {
+	    bool flag;
+	    if (left.has_sign() && right.has_sign())
+		  flag = (int64_t)word_value(left) < (int64_t)word_value(right);
+	    else
+		  flag = left.as_ulong64() < right.as_ulong64();
+	    return flag? verinum::V1 : verinum::V0;
+      }
+
       verinum::V left_pad = verinum::V0;
       verinum::V right_pad = verinum::V0;
       bool signed_calc = left.has_sign() && right.has_sign();
@@ -1003,6 +1107,14 @@ static verinum::V add_with_carry(verinum::V l, verinum::V r, verinum::V&c)
 
 verinum operator ~ (const verinum&left)
 {
+      if (fits_word(left) && !left.is_string()) {
+	    verinum val (~left.as_ulong64(), left.len());
+	    val.has_len(left.has_len());
+	    val.has_sign(left.has_sign());
+	    val.is_single(left.is_single());
+	    return val;
+      }
+
       verinum val = left;
       for (unsigned idx = 0 ;  idx < val.len() ;  idx += 1)
 	    switch (val[idx]) {
@@ -1044,6 +1156,59 @@ verinum operator + (const verinum&left, const verinum&right)
 	    return result;
       }
 
+	// The sum, including the possible extra bit, fits in a word.
+      if ((min_len > 0) && (max_len < 64)) {
+	    uint64_t val = word_value(left) + word_value(right);
+	    unsigned len = max_len;
+	    if (!has_len_flag) {
+		  uint64_t top = (val >> max_len) & 1;
+		  if (signed_flag) {
+			if (top != ((val >> (max_len-1)) & 1)) len += 1;
+		  } else {
+			if (top != 0) len += 1;
+		  }
+	    }
+	    return word_result(val, len, has_len_flag, signed_flag);
+      }
+
+	// Otherwise add the values a word at a time.
+      if (min_len > 0) {
+	    unsigned nwords = (max_len + 1 + 63) / 64;
+	    uint64_t*lwords = new uint64_t[2*nwords];
+	    uint64_t*rwords = lwords + nwords;
+	    left.extend_words_(lwords, nwords);
+	    right.extend_words_(rwords, nwords);
+
+	    uint64_t carry = 0;
+	    for (unsigned idx = 0 ;  idx < nwords ;  idx += 1) {
+		  uint64_t sum = lwords[idx] + carry;
+		  carry = (sum < carry)? 1 : 0;
+		  lwords[idx] = sum + rwords[idx];
+		  if (lwords[idx] < sum) carry = 1;
+	    }
+
+	    unsigned len = max_len;
+	    if (!has_len_flag) {
+		  unsigned top = (lwords[max_len/64] >> (max_len%64)) & 1;
+		  unsigned next = (lwords[(max_len-1)/64] >> ((max_len-1)%64)) & 1;
+		  if (signed_flag) {
+			if (top != next) len += 1;
+		  } else {
+			if (top != 0) len += 1;
+		  }
+	    }
+
+	    verinum result (verinum::V0, len, has_len_flag);
+	    result.has_sign(signed_flag);
+	    for (unsigned idx = 0 ;  idx < result.nwords_() ;  idx += 1)
+		  result.bits_[idx] = lwords[idx];
+	    if (len % 64)
+		  result.bits_[result.nwords_()-1] &= word_mask(len % 64);
+
+	    delete[]lwords;
+	    return result;
+      }
+
       verinum::V*val_bits = new verinum::V[max_len+1];
 
       verinum::V carry = verinum::V0;
@@ -1098,6 +1263,52 @@ verinum operator - (const verinum&left, const verinum&right)
 	    return result;
       }
 
+	// The difference, including the possible extra bit, fits in
+	// a word.
+      if ((min_len > 0) && (max_len < 64)) {
+	    uint64_t val = word_value(left) - word_value(right);
+	    unsigned len = max_len;
+	    if (signed_flag && !has_len_flag) {
+		  if (((val >> max_len) & 1) != ((val >> (max_len-1)) & 1))
+			len += 1;
+	    }
+	    return word_result(val, len, has_len_flag, signed_flag);
+      }
+
+	// Otherwise subtract the values a word at a time.
+      if (min_len > 0) {
+	    unsigned nwords = (max_len + 1 + 63) / 64;
+	    uint64_t*lwords = new uint64_t[2*nwords];
+	    uint64_t*rwords = lwords + nwords;
+	    left.extend_words_(lwords, nwords);
+	    right.extend_words_(rwords, nwords);
+
+	    uint64_t borrow = 0;
+	    for (unsigned idx = 0 ;  idx < nwords ;  idx += 1) {
+		  uint64_t dif = lwords[idx] - borrow;
+		  borrow = (lwords[idx] < borrow)? 1 : 0;
+		  if (dif < rwords[idx]) borrow = 1;
+		  lwords[idx] = dif - rwords[idx];
+	    }
+
+	    unsigned len = max_len;
+	    if (signed_flag && !has_len_flag) {
+		  unsigned top = (lwords[max_len/64] >> (max_len%64)) & 1;
+		  unsigned next = (lwords[(max_len-1)/64] >> ((max_len-1)%64)) & 1;
+		  if (top != next) len += 1;
+	    }
+
+	    verinum result (verinum::V0, len, has_len_flag);
+	    result.has_sign(signed_flag);
+	    for (unsigned idx = 0 ;  idx < result.nwords_() ;  idx += 1)
+		  result.bits_[idx] = lwords[idx];
+	    if (len % 64)
+		  result.bits_[result.nwords_()-1] &= word_mask(len % 64);
+
+	    delete[]lwords;
+	    return result;
+      }
+
       verinum::V*val_bits = new verinum::V[max_len+1];
 
       verinum::V carry = verinum::V1;
@@ -1146,6 +1357,15 @@ verinum operator - (const verinum&right)
 	    return result;
       }
 
+      if ((len > 0) && (len < 64)) {
+	    uint64_t val = - word_value(right);
+	    if (signed_flag && !has_len_flag) {
+		  if (((val >> len) & 1) != ((val >> (len-1)) & 1))
+			len += 1;
+	    }
+	    return word_result(val, len, has_len_flag, signed_flag);
+      }
+
       verinum::V*val_bits = new verinum::V[len+1];
 
       verinum::V carry = verinum::V1;
@@ -1191,6 +1411,14 @@ verinum operator * (const verinum&left, const verinum&right)
 	    return result;
       }
 
+	// The product fits in a word, so use native multiplication.
+	// The low len bits of the product do not depend on the bits
+	// above len in the operands.
+      if ((l_len > 0) && (r_len > 0) && (len <= 64)) {
+	    uint64_t val = word_value(left) * word_value(right);
+	    return trim_vnum(word_result(val, len, has_len_flag, signed_flag));
+      }
+
       verinum result(verinum::V0, len, has_len_flag);
       result.has_sign(signed_flag);
 
@@ -1311,6 +1539,11 @@ verinum operator << (const verinum&that, unsigned shift)
       unsigned len = that.len();
       if (!has_len_flag) len += shift;
 
+      if ((len <= 64) && (shift < 64) && that.is_defined()) {
+	    uint64_t val = that.as_ulong64() << shift;
+	    return trim_vnum(word_result(val, len, has_len_flag, that.has_sign()));
+      }
+
       verinum result(verinum::V0, len, has_len_flag);
       result.has_sign(that.has_sign());
 
@@ -1335,6 +1568,16 @@ verinum operator >> (const verinum&that, unsigned shift)
 	    return result;
       }
 
+      if ((len <= 64) && that.is_defined()) {
+	    uint64_t val = word_value(that);
+	    if (that.has_sign())
+		  val = (uint64_t) ((int64_t)val >> shift);
+	    else
+		  val = val >> shift;
+	    if (!has_len_flag) len -= shift;
+	    return trim_vnum(word_result(val, len, has_len_flag, that.has_sign()));
+      }
+
       if (!has_len_flag) len -= shift;
       verinum result(sign_bit, len, has_len_flag);
       result.has_sign(that.has_sign());
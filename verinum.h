@@ -114,8 +114,26 @@ class verinum {
     private:
       void signed_trim();
 
+	// Manage the packed bit storage.
+      void alloc_bits_(unsigned nbits);
+      void extend_words_(uint64_t*dst, unsigned nwords) const;
+      unsigned nwords_() const { return (nbits_ + 63) / 64; }
+      inline V get_bit_(unsigned idx) const;
+      inline void set_bit_(unsigned idx, V val);
+
+	// Addition and subtraction work on whole words.
+      friend verinum operator + (const verinum&left, const verinum&right);
+      friend verinum operator - (const verinum&left, const verinum&right);
+
     private:
-      V* bits_;
+	// The bits are packed 64 to a word in two planes. The a plane
+	// holds the low bit of the V value of each bit, and the b
+	// plane holds the high bit, so defined values have an all
+	// zero b plane. The bits_ array holds all the a words followed
+	// by all the b words. Values that fit in a single word use the
+	// local_bits_ array instead of allocating from the heap.
+      uint64_t*bits_;
+      uint64_t local_bits_[2];
       unsigned nbits_;
       bool has_len_;
       bool has_sign_;
@@ -284,6 +284,18 @@ void vpip_set_return_value(int value)
       assert(vpip_routines);
       vpip_routines->set_return_value(value);
 }
+PLI_INT32 vpip_get_array_words(vpiHandle ref, PLI_INT32 index,
+                               PLI_INT32 count, s_vpi_vecval*buf)
+{
+      assert(vpip_routines);
+      return vpip_routines->get_array_words(ref, index, count, buf);
+}
+PLI_INT32 vpip_put_array_words(vpiHandle ref, PLI_INT32 index,
+                               PLI_INT32 count, const s_vpi_vecval*buf)
+{
+      assert(vpip_routines);
+      return vpip_routines->put_array_words(ref, index, count, buf);
+}
 
 DLLEXPORT PLI_UINT32 vpip_set_callback(vpip_routines_s*routines, PLI_UINT32 version)
 {
@@ -514,48 +514,75 @@ static PLI_INT32 sys_fread_compiletf(ICARUS_VPI_CONST PLI_BYTE8*name)
 }
 
 /*
- * The pattern here is get the current vector, load the new bits on
- * top of the old ones and then put the modified vector. We need the
- * "get" first so that if we run out of bits in the file we keep the
- * original ones.
+ * Pack bpe bytes from buf (MSByte first) into the words entries of
+ * vector in the vpiVectorVal format. Each entry is built from up to
+ * four bytes.
  */
-static unsigned fread_word(FILE *fp, vpiHandle word,
-                           unsigned words, unsigned bpe, s_vpi_vecval *vector)
+static void fread_pack(const unsigned char *buf, unsigned words,
+                       unsigned bpe, s_vpi_vecval *vector)
 {
-      int bidx;
-      s_vpi_value val;
-      struct t_vpi_vecval *cur = &vector[words-1];
-      unsigned rtn = 0;
+      unsigned widx;
+      for (widx = 0; widx < words; widx += 1) {
+	    unsigned lo = widx*4;
+	    unsigned hi = (lo+4 < bpe) ? lo+4 : bpe;
+	    unsigned bidx;
+	    PLI_UINT32 aval = 0;
+	    for (bidx = hi; bidx > lo; bidx -= 1)
+		  aval = (aval << 8) | buf[bpe-bidx];
+	    vector[widx].aval = aval;
+	    vector[widx].bval = 0;
+      }
+}
 
-	/* Get the current bits from the register and copy them to
-	 * my local vector. */
+/*
+ * Store the nbytes bytes in buf into the word. The bytes are MSByte
+ * first. If there are fewer than bpe bytes (the file ended in the
+ * middle of the word) then we get the current vector and load the new
+ * bits on top of the old ones, so the bits past the end keep their
+ * original value.
+ */
+static unsigned fread_word(const unsigned char *buf, unsigned nbytes,
+                           vpiHandle word, unsigned words, unsigned bpe,
+                           s_vpi_vecval *vector)
+{
+      s_vpi_value val;
       val.format = vpiVectorVal;
-      vpi_get_value(word, &val);
-      for (bidx = 0; (unsigned)bidx < words; bidx += 1) {
-	    vector[bidx].aval = val.value.vector[bidx].aval;
-	    vector[bidx].bval = val.value.vector[bidx].bval;
-      }
 
-	/* Copy the bytes to the local vector MSByte first. */
-      for (bidx = bpe-1; bidx >= 0; bidx -= 1) {
-	    unsigned clr_mask, bnum;
-	    int byte = fgetc(fp);
-	    if (byte == EOF) break;
-	      /* Clear the current byte and load the new value. */
-	    bnum = bidx % 4;
-	    clr_mask = ~(0xff << bnum*8);
-	    cur->aval &= clr_mask;
-	    cur->bval &= clr_mask;
-	    cur->aval |= byte << bnum*8;
-	    rtn += 1;
-	    if (bnum == 0) cur -= 1;
+      if (nbytes == bpe) {
+	    fread_pack(buf, words, bpe, vector);
+      } else {
+	    int bidx;
+	    unsigned idx;
+	    struct t_vpi_vecval *cur = &vector[words-1];
+
+	      /* Get the current bits from the register and copy them
+	       * to my local vector. */
+	    vpi_get_value(word, &val);
+	    for (idx = 0; idx < words; idx += 1) {
+		  vector[idx].aval = val.value.vector[idx].aval;
+		  vector[idx].bval = val.value.vector[idx].bval;
+	    }
+
+	      /* Copy the bytes to the local vector MSByte first. */
+	    idx = 0;
+	    for (bidx = bpe-1; bidx >= 0 && idx < nbytes; bidx -= 1) {
+		  unsigned clr_mask, bnum;
+		    /* Clear the current byte and load the new value. */
+		  bnum = bidx % 4;
+		  clr_mask = ~(0xff << bnum*8);
+		  cur->aval &= clr_mask;
+		  cur->bval &= clr_mask;
+		  cur->aval |= buf[idx] << bnum*8;
+		  idx += 1;
+		  if (bnum == 0) cur -= 1;
+	    }
       }
 
 	/* Put the updated bits into the register. */
       val.value.vector = vector;
       vpi_put_value(word, &val, 0, vpiNoDelay);
 
-      return rtn;
+      return nbytes;
 }
 
 static PLI_INT32 sys_fread_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
@@ -567,8 +594,10 @@ static PLI_INT32 sys_fread_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       PLI_UINT32 fd_mcd;
       PLI_INT32 start, count, width, rtn;
       unsigned is_mem, bpe, words;
+      unsigned chunk;
       FILE *fp;
       s_vpi_vecval *vector;
+      unsigned char *buf;
       errno = 0;
 
 	/* Get the register/memory. */
@@ -671,18 +700,53 @@ static PLI_INT32 sys_fread_calltf(ICARUS_VPI_CONST PLI_BYTE8*name)
       bpe = (width+7)/8;
 
       assert(count >= 0);
+	/* Read the file a block of words at a time instead of a byte
+	 * at a time. The complete words of a block are packed and
+	 * stored into the memory with a single vpip_put_array_words()
+	 * call. A partial word at the end of the file, or any words
+	 * the bulk store does not take, go through fread_word(). */
+      chunk = 65536 / bpe;
+      if (chunk == 0) chunk = 1;
+      if (chunk > (unsigned)count) chunk = count;
+      buf = malloc(chunk*bpe);
+      rtn = 0;
       if (is_mem) {
-	    unsigned idx;
-	    rtn = 0;
-	    for (idx = 0; idx < (unsigned)count; idx += 1) {
-		  vpiHandle word;
-		  word = vpi_handle_by_index(mem_reg, start+(signed)idx);
-		  rtn += fread_word(fp, word, words, bpe, vector);
-		  if (feof(fp)) break;
+	    s_vpi_vecval *block = malloc(chunk*words*sizeof(s_vpi_vecval));
+	    unsigned idx = 0;
+	    while (idx < (unsigned)count) {
+		  unsigned want = (unsigned)count - idx;
+		  unsigned nbytes, nfull, done, pos;
+		  if (want > chunk) want = chunk;
+		  nbytes = fread(buf, 1, want*bpe, fp);
+		  nfull = nbytes / bpe;
+		  for (pos = 0; pos < nfull; pos += 1)
+			fread_pack(buf+pos*bpe, words, bpe, block+pos*words);
+		  done = 0;
+		  if (nfull > 0) {
+			PLI_INT32 cnt = vpip_put_array_words(mem_reg,
+			                                     start+(signed)idx,
+			                                     nfull, block);
+			if (cnt > 0) done = cnt;
+		  }
+		  rtn += done*bpe;
+		  idx += done;
+		  for (pos = done*bpe; pos < nbytes; pos += bpe, idx += 1) {
+			vpiHandle word;
+			unsigned cnt = nbytes - pos;
+			if (cnt > bpe) cnt = bpe;
+			word = vpi_handle_by_index(mem_reg, start+(signed)idx);
+			rtn += fread_word(buf+pos, cnt, word, words, bpe,
+			                  vector);
+		  }
+		  if (nbytes < want*bpe) break;
 	    }
+	    free(block);
       } else {
-	    rtn = fread_word(fp, mem_reg, words, bpe, vector);
+	    unsigned nbytes = fread(buf, 1, bpe, fp);
+	    if (nbytes > 0)
+		  rtn = fread_word(buf, nbytes, mem_reg, words, bpe, vector);
       }
+      free(buf);
       free(vector);
 
 	/* Return the number of bytes read. */
@@ -520,23 +520,41 @@ PLI_INT32 sys_random_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       return 0;
 }
 
+/*
+ * $random and $urandom are called very often, so the compiletf saves
+ * the seed handle (or 0 if there is no seed) with the call. The calltf
+ * then does not need to build an argument iterator each time.
+ */
+static PLI_INT32 sys_random_seed_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
+{
+      vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
+      vpiHandle argv = vpi_iterate(vpiArgument, callh);
+      vpiHandle seed = 0;
+
+      if (argv) {
+            seed = vpi_scan(argv);
+            vpi_free_object(argv);
+      }
+      vpi_put_userdata(callh, (void *) seed);
+
+      return sys_random_compiletf(name);
+}
+
 static PLI_INT32 sys_random_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed = 0;
+      vpiHandle callh, seed;
       s_vpi_value val;
       static long i_seed = 0;
       long a_seed;
 
       (void)name; /* Parameter is not used. */
 
-      /* Get the argument list and look for a seed. If it is there,
-         get the value and reseed the random number generator. */
+      /* Look for a seed. If it is there, get the value and reseed
+         the random number generator. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
+      seed = (vpiHandle) vpi_get_userdata(callh);
       val.format = vpiIntVal;
-      if (argv) {
-            seed = vpi_scan(argv);
-            vpi_free_object(argv);
+      if (seed) {
             vpi_get_value(seed, &val);
             a_seed = val.value.integer;
       } else a_seed = i_seed;
@@ -554,12 +572,35 @@ static PLI_INT32 sys_random_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
       return 0;
 }
 
+/*
+ * The $urandom_range compiletf saves the argument handles with the
+ * call so the calltf only has to read their values. The blocks are
+ * also kept in a list so they can be freed at the end of simulation.
+ */
+struct urandom_range_args_s {
+      vpiHandle maxval, minval;
+      struct urandom_range_args_s *next;
+};
+static struct urandom_range_args_s *urandom_range_args = 0;
+
+static PLI_INT32 free_urandom_range_args(p_cb_data cb_data)
+{
+      (void)cb_data; /* Parameter is not used. */
+      while (urandom_range_args) {
+	    struct urandom_range_args_s *next = urandom_range_args->next;
+	    free(urandom_range_args);
+	    urandom_range_args = next;
+      }
+      return 0;
+}
+
 /* From SystemVerilog. */
 static PLI_INT32 sys_urandom_range_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
       vpiHandle callh = vpi_handle(vpiSysTfCall, 0);
       vpiHandle argv = vpi_iterate(vpiArgument, callh);
       vpiHandle arg;
+      struct urandom_range_args_s *args;
 
       /* Check that there are arguments. */
       if (argv == 0) {
@@ -568,10 +609,17 @@ static PLI_INT32 sys_urandom_range_compiletf(ICARUS_VPI_CONST PLI_BYTE8 *name)
             return 0;
       }
 
+      args = (struct urandom_range_args_s *) malloc(sizeof(*args));
+      args->next = urandom_range_args;
+      urandom_range_args = args;
+      vpi_put_userdata(callh, (void *) args);
+
       /* Check that there is at least one argument. */
       arg = vpi_scan(argv);  /* This should never be zero. */
       assert(arg);
+      args->maxval = arg;
       arg = vpi_scan(argv);
+      args->minval = arg;
       /* Is this a single argument function call? */
       if (arg == 0) return 0;
 
@@ -605,20 +653,18 @@ static unsigned long urandom(long *seed, unsigned long max, unsigned long min)
 /* From SystemVerilog. */
 static PLI_INT32 sys_urandom_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, seed = 0;
+      vpiHandle callh, seed;
       s_vpi_value val;
-      long i_seed;
+      long i_seed = 0;
 
       (void)name; /* Parameter is not used. */
 
-      /* Get the argument list and look for a seed. If it is there,
-         get the value and reseed the random number generator. */
+      /* Look for a seed. If it is there, get the value and reseed
+         the random number generator. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
+      seed = (vpiHandle) vpi_get_userdata(callh);
       val.format = vpiIntVal;
-      if (argv) {
-            seed = vpi_scan(argv);
-            vpi_free_object(argv);
+      if (seed) {
             vpi_get_value(seed, &val);
             i_seed = val.value.integer;
       }
@@ -643,27 +689,25 @@ static PLI_INT32 sys_urandom_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 /* From SystemVerilog. */
 static PLI_INT32 sys_urandom_range_calltf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 {
-      vpiHandle callh, argv, maxval, minval;
+      vpiHandle callh;
+      struct urandom_range_args_s *args;
       s_vpi_value val;
       unsigned long i_maxval, i_minval;
 
       (void)name; /* Parameter is not used. */
 
-      /* Get the argument handles and convert them. */
+      /* Get the saved argument handles and convert them. */
       callh = vpi_handle(vpiSysTfCall, 0);
-      argv = vpi_iterate(vpiArgument, callh);
-      maxval = vpi_scan(argv);
-      minval = vpi_scan(argv);
+      args = (struct urandom_range_args_s *) vpi_get_userdata(callh);
 
       val.format = vpiIntVal;
-      vpi_get_value(maxval, &val);
+      vpi_get_value(args->maxval, &val);
       i_maxval = val.value.integer;
 
       /* Is this a two or one argument function call? */
-      if (minval) {
-	    vpi_get_value(minval, &val);
+      if (args->minval) {
+	    vpi_get_value(args->minval, &val);
 	    i_minval = val.value.integer;
-	    vpi_free_object(argv);
       } else {
 	    i_minval = 0;
       }
@@ -932,6 +976,7 @@ static PLI_INT32 sys_rand_func_sizetf(ICARUS_VPI_CONST PLI_BYTE8 *name)
 
 void sys_random_register(void)
 {
+      s_cb_data cb_data;
       s_vpi_systf_data tf_data;
       vpiHandle res;
 
@@ -939,7 +984,7 @@ void sys_random_register(void)
       tf_data.sysfunctype = vpiSysFuncInt;
       tf_data.tfname = "$random";
       tf_data.calltf = sys_random_calltf;
-      tf_data.compiletf = sys_random_compiletf;
+      tf_data.compiletf = sys_random_seed_compiletf;
       tf_data.sizetf = sys_rand_func_sizetf;
       tf_data.user_data = "$random";
       res = vpi_register_systf(&tf_data);
@@ -950,7 +995,7 @@ void sys_random_register(void)
       tf_data.sysfunctype = vpiSysFuncSized;
       tf_data.tfname = "$urandom";
       tf_data.calltf = sys_urandom_calltf;
-      tf_data.compiletf = sys_random_compiletf;
+      tf_data.compiletf = sys_random_seed_compiletf;
       tf_data.sizetf = sys_rand_func_sizetf;
       tf_data.user_data = "$urandom";
       res = vpi_register_systf(&tf_data);
@@ -1036,4 +1081,10 @@ void sys_random_register(void)
       tf_data.user_data = "$dist_erlang";
       res = vpi_register_systf(&tf_data);
       vpip_make_systf_system_defined(res);
+
+      cb_data.reason = cbEndOfSimulation;
+      cb_data.time = 0;
+      cb_data.cb_rtn = free_urandom_range_args;
+      cb_data.user_data = "system";
+      vpi_register_cb(&cb_data);
 }
@@ -659,6 +659,20 @@ extern void vpip_mcd_rawwrite(PLI_UINT32 mcd, const char*buf, size_t count);
 extern void vpip_count_drivers(vpiHandle ref, unsigned idx,
                                unsigned counts[4]);
 
+  /* Read or write a range of words of a memory in a single call. The
+     'ref' argument must reference a vector memory, 'index' is the
+     (declared) index of the first word and 'count' is the number of
+     words. The words are packed one after the other in 'buf', each
+     taking (width+31)/32 entries in the vpiVectorVal format. The
+     return value is the number of words actually transferred, which
+     is less than 'count' if the range runs past the end of the
+     array. Writing words has the same effect as vpi_put_value with
+     vpiNoDelay on each word. */
+extern PLI_INT32 vpip_get_array_words(vpiHandle ref, PLI_INT32 index,
+                                      PLI_INT32 count, s_vpi_vecval*buf);
+extern PLI_INT32 vpip_put_array_words(vpiHandle ref, PLI_INT32 index,
+                                      PLI_INT32 count, const s_vpi_vecval*buf);
+
 /*
  * Stopgap fix for br916. We need to reject any attempt to pass a thread
  * variable to $strobe or $monitor. To do this, we use some private VPI
@@ -688,7 +702,7 @@ extern void vpip_count_drivers(vpiHandle ref, unsigned idx,
  */
 
 // Increment the version number any time vpip_routines_s is changed.
-static const PLI_UINT32 vpip_routines_version = 1;
+static const PLI_UINT32 vpip_routines_version = 2;
 
 typedef struct {
     vpiHandle   (*register_cb)(p_cb_data);
@@ -729,6 +743,8 @@ typedef struct {
     void        (*make_systf_system_defined)(vpiHandle);
     void        (*mcd_rawwrite)(PLI_UINT32, const char*, size_t);
     void        (*set_return_value)(int);
+    PLI_INT32   (*get_array_words)(vpiHandle, PLI_INT32, PLI_INT32, s_vpi_vecval*);
+    PLI_INT32   (*put_array_words)(vpiHandle, PLI_INT32, PLI_INT32, const s_vpi_vecval*);
 } vpip_routines_s;
 
 extern DLLEXPORT PLI_UINT32 vpip_set_callback(vpip_routines_s*routines, PLI_UINT32 version);
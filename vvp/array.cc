@@ -778,6 +778,188 @@ string __vpiArray::get_word_str(unsigned address)
       return "";
 }
 
+/*
+ * The vvp_vector4_t a/b bit encoding is the same as the s_vpi_vecval
+ * aval/bval encoding, so the words of a vals4 array can be moved to
+ * and from the VPI buffers without going through a vvp_vector4_t.
+ */
+static void bits_to_vecval(const unsigned long*abits, const unsigned long*bbits,
+			   unsigned wid, s_vpi_vecval*dst)
+{
+      const unsigned BPW = 8 * sizeof(unsigned long);
+
+      for (unsigned bit = 0 ; bit < wid ; bit += 32) {
+	    unsigned long aval = abits[bit/BPW] >> (bit%BPW);
+	    unsigned long bval = bbits[bit/BPW] >> (bit%BPW);
+	    if (wid - bit < 32) {
+		  unsigned long mask = (1UL << (wid-bit)) - 1;
+		  aval &= mask;
+		  bval &= mask;
+	    }
+	    dst->aval = (PLI_INT32) (aval & 0xffffffffUL);
+	    dst->bval = (PLI_INT32) (bval & 0xffffffffUL);
+	    dst += 1;
+      }
+}
+
+static void vecval_to_bits(const s_vpi_vecval*src, unsigned wid,
+			   unsigned long*abits, unsigned long*bbits)
+{
+      const unsigned BPW = 8 * sizeof(unsigned long);
+      unsigned cnt = (wid + BPW - 1) / BPW;
+
+      for (unsigned idx = 0 ; idx < cnt ; idx += 1) {
+	    abits[idx] = 0;
+	    bbits[idx] = 0;
+      }
+
+      for (unsigned bit = 0 ; bit < wid ; bit += 32) {
+	    unsigned long aval = (PLI_UINT32) src->aval;
+	    unsigned long bval = (PLI_UINT32) src->bval;
+	    if (wid - bit < 32) {
+		  unsigned long mask = (1UL << (wid-bit)) - 1;
+		  aval &= mask;
+		  bval &= mask;
+	    }
+	    abits[bit/BPW] |= aval << (bit%BPW);
+	    bbits[bit/BPW] |= bval << (bit%BPW);
+	    src += 1;
+      }
+}
+
+void __vpiArray::get_words(unsigned address, unsigned count, s_vpi_vecval*buf)
+{
+      unsigned wid = get_word_size();
+      unsigned nval = (wid + 31) / 32;
+
+      if (vals4) {
+	    unsigned cnt = vals4->word_stride();
+	    unsigned long*abits = new unsigned long[2*cnt];
+	    unsigned long*bbits = abits + cnt;
+	    for (unsigned idx = 0 ; idx < count ; idx += 1) {
+		  vals4->get_word_bits(address+idx, abits, bbits);
+		  bits_to_vecval(abits, bbits, wid, buf + idx*nval);
+	    }
+	    delete[]abits;
+	    return;
+      }
+
+	// Other vector arrays go through the vvp_vector4_t form.
+      for (unsigned idx = 0 ; idx < count ; idx += 1) {
+	    vvp_vector4_t val = get_word(address+idx);
+	    s_vpi_vecval*dst = buf + idx*nval;
+	    for (unsigned word = 0 ; word < nval ; word += 1) {
+		  dst[word].aval = 0;
+		  dst[word].bval = 0;
+	    }
+	    for (unsigned bit = 0 ; bit < wid ; bit += 1) {
+		  PLI_INT32 mask = 1 << (bit%32);
+		  switch (val.value(bit)) {
+		      case BIT4_0:
+			break;
+		      case BIT4_1:
+			dst[bit/32].aval |= mask;
+			break;
+		      case BIT4_X:
+			dst[bit/32].aval |= mask;
+			dst[bit/32].bval |= mask;
+			break;
+		      case BIT4_Z:
+			dst[bit/32].bval |= mask;
+			break;
+		  }
+	    }
+      }
+}
+
+void __vpiArray::put_words(unsigned address, unsigned count, const s_vpi_vecval*buf)
+{
+      unsigned wid = get_word_size();
+      unsigned nval = (wid + 31) / 32;
+
+      if (vals4) {
+	    unsigned cnt = vals4->word_stride();
+	    unsigned long*abits = new unsigned long[2*cnt];
+	    unsigned long*bbits = abits + cnt;
+	    for (unsigned idx = 0 ; idx < count ; idx += 1) {
+		  vecval_to_bits(buf + idx*nval, wid, abits, bbits);
+		  vals4->set_word_bits(address+idx, abits, bbits);
+	    }
+	    delete[]abits;
+
+	      // Only walk the ports and callbacks if there are any.
+	    if (ports_ || vpi_callbacks) {
+		  for (unsigned idx = 0 ; idx < count ; idx += 1)
+			word_change(address+idx);
+	    }
+	    return;
+      }
+
+	// Other vector arrays go through the vvp_vector4_t form.
+      for (unsigned idx = 0 ; idx < count ; idx += 1) {
+	    const s_vpi_vecval*src = buf + idx*nval;
+	    vvp_vector4_t val (wid);
+	    for (unsigned bit = 0 ; bit < wid ; bit += 1) {
+		  PLI_INT32 mask = 1 << (bit%32);
+		  int code = ((src[bit/32].aval & mask)? 1 : 0)
+		           | ((src[bit/32].bval & mask)? 2 : 0);
+		  static const vvp_bit4_t bit_map[4] = {
+			BIT4_0, BIT4_1, BIT4_Z, BIT4_X };
+		  val.set_bit(bit, bit_map[code]);
+	    }
+	    set_word(address+idx, 0, val);
+      }
+}
+
+/*
+ * Check that this is an array of vector words, and clip the range to
+ * the words that are in the array. Return the number of words, or 0
+ * if the array or range cannot be used.
+ */
+static unsigned array_words_range(vpiHandle ref, PLI_INT32 index,
+				  PLI_INT32 count, __vpiArray*&arr,
+				  unsigned&address)
+{
+      arr = dynamic_cast<__vpiArray*>(ref);
+      if (arr == 0 || count <= 0 || arr->get_size() == 0)
+	    return 0;
+
+      if (vpi_array_is_real(arr) || vpi_array_is_string(arr))
+	    return 0;
+      if (dynamic_cast<vvp_darray_object*>(arr->vals))
+	    return 0;
+
+      long addr = (long)index - arr->first_addr.get_value();
+      if (addr < 0 || addr >= (long)arr->get_size())
+	    return 0;
+
+      address = addr;
+      unsigned avail = arr->get_size() - address;
+      return ((unsigned)count < avail)? (unsigned)count : avail;
+}
+
+extern "C" PLI_INT32 vpip_get_array_words(vpiHandle ref, PLI_INT32 index,
+                                          PLI_INT32 count, s_vpi_vecval*buf)
+{
+      __vpiArray*arr;
+      unsigned address;
+      unsigned nwords = array_words_range(ref, index, count, arr, address);
+      if (nwords > 0)
+	    arr->get_words(address, nwords, buf);
+      return nwords;
+}
+
+extern "C" PLI_INT32 vpip_put_array_words(vpiHandle ref, PLI_INT32 index,
+                                          PLI_INT32 count, const s_vpi_vecval*buf)
+{
+      __vpiArray*arr;
+      unsigned address;
+      unsigned nwords = array_words_range(ref, index, count, arr, address);
+      if (nwords > 0)
+	    arr->put_words(address, nwords, buf);
+      return nwords;
+}
+
 vpiHandle vpip_make_array(char*label, const char*name,
 				 int first_addr, int last_addr,
 				 bool signed_flag)
@@ -22,6 +22,7 @@
 # include  "vpi_priv.h"
 # include  "config.h"
 # include  <map>
+# include  <cstring>
 #ifdef CHECK_WITH_VALGRIND
 # include  "vvp_cleanup.h"
 #endif
@@ -40,6 +41,9 @@ class class_property_t {
       virtual ~class_property_t() =0;
 	// How much space does an instance of this property require?
       virtual size_t instance_size() const =0;
+	// Is the constructed property all zero bits with nothing to
+	// destruct? Such properties are set up with a single memset.
+      virtual bool is_trivial() const { return false; }
 
       void set_offset(size_t off) { offset_ = off; }
 
@@ -128,6 +132,7 @@ template <class T> class property_atom : public class_property_t {
       ~property_atom() { }
 
       size_t instance_size() const { return sizeof(T); }
+      bool is_trivial() const { return true; }
 
     public:
       void construct(char*buf) const
@@ -197,6 +202,7 @@ template <class T> class property_real : public class_property_t {
       ~property_real() { }
 
       size_t instance_size() const { return sizeof(T); }
+      bool is_trivial() const { return true; }
 
     public:
       void construct(char*buf) const
@@ -400,12 +406,18 @@ class_type::class_type(const string&nam, size_t nprop)
 : class_name_(nam), properties_(nprop)
 {
       instance_size_ = 0;
+      free_insts_ = 0;
 }
 
 class_type::~class_type()
 {
       for (size_t idx = 0 ; idx < properties_.size() ; idx += 1)
 	    delete properties_[idx].type;
+
+      while (char*buf = free_insts_) {
+	    free_insts_ = *reinterpret_cast<char**> (buf);
+	    delete[]buf;
+      }
 }
 
 void class_type::set_property(size_t idx, const string&name, const string&type, uint64_t array_size)
@@ -478,14 +490,39 @@ void class_type::finish_setup(void)
 		  accum += cur->first;
 	    }
       }
+
+	// Only the properties that are not trivial need to be
+	// constructed and destructed one at a time. The rest are
+	// set up by clearing the whole instance.
+      nontrivial_.clear();
+      for (size_t idx = 0 ; idx < properties_.size() ; idx += 1) {
+	    if (! properties_[idx].type->is_trivial())
+		  nontrivial_.push_back(properties_[idx].type);
+      }
+
+	// A freed instance holds the link to the next one, so it
+	// must be at least big enough for a pointer.
+      if (instance_size_ < sizeof(char*))
+	    instance_size_ = sizeof(char*);
 }
 
+/*
+ * Deleted instances are kept in a list in the class definition and
+ * reused by the next instance_new(), so a testbench that creates and
+ * drops many objects of the same class does not go back to the heap
+ * for each one.
+ */
 class_type::inst_t class_type::instance_new() const
 {
-      char*buf = new char [instance_size_];
+      char*buf = free_insts_;
+      if (buf)
+	    free_insts_ = *reinterpret_cast<char**> (buf);
+      else
+	    buf = new char [instance_size_];
 
-      for (size_t idx = 0 ; idx < properties_.size() ; idx += 1)
-	    properties_[idx].type->construct(buf);
+      memset(buf, 0, instance_size_);
+      for (size_t idx = 0 ; idx < nontrivial_.size() ; idx += 1)
+	    nontrivial_[idx]->construct(buf);
 
       return reinterpret_cast<inst_t> (buf);
 }
@@ -494,10 +531,11 @@ void class_type::instance_delete(class_type::inst_t obj) const
 {
       char*buf = reinterpret_cast<char*> (obj);
 
-      for (size_t idx = 0 ; idx < properties_.size() ; idx += 1)
-	    properties_[idx].type->destruct(buf);
+      for (size_t idx = 0 ; idx < nontrivial_.size() ; idx += 1)
+	    nontrivial_[idx]->destruct(buf);
 
-      delete[]buf;
+      *reinterpret_cast<char**> (buf) = free_insts_;
+      free_insts_ = buf;
 }
 
 void class_type::set_vec4(class_type::inst_t obj, size_t pid,
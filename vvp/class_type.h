@@ -83,6 +83,10 @@ class class_type : public __vpiHandle {
       };
       std::vector<prop_t> properties_;
       size_t instance_size_;
+	// Properties that need to be constructed and destructed.
+      std::vector<class_property_t*> nontrivial_;
+	// Deleted instances, ready to be reused.
+      mutable char*free_insts_;
 };
 
 #endif /* IVL_class_type_H */
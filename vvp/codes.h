@@ -310,4 +310,10 @@ extern vvp_code_t codespace_allocate(void);
 extern vvp_code_t codespace_next(void);
 extern vvp_code_t codespace_null(void);
 
+/*
+ * Return the assembler mnemonic of the opcode function, or 0 if the
+ * function is not in the opcode table (i.e. it is internal).
+ */
+extern const char* compile_opcode_name(vvp_code_fun opcode);
+
 #endif /* IVL_codes_H */
@@ -321,6 +321,15 @@ static int opcode_compare(const void*k, const void*r)
       return strcmp(kp, rp->mnemonic);
 }
 
+const char* compile_opcode_name(vvp_code_fun opcode)
+{
+      for (unsigned idx = 0 ; idx < opcode_count ; idx += 1) {
+	    if (opcode_table[idx].opcode == opcode)
+		  return opcode_table[idx].mnemonic;
+      }
+      return 0;
+}
+
 /*
  * Keep a symbol table of addresses within code space. Labels on
  * executable opcodes are mapped to their address here.
@@ -811,6 +820,16 @@ void compile_cleanup(void)
       compile_island_cleanup();
       compile_array_cleanup();
 
+      if (schedule_levelize_flag) {
+	    if (verbose_flag) {
+		  fprintf(stderr, " ... Levelizing logic\n");
+		  fflush(stderr);
+	    }
+	    schedule_levelize();
+      }
+
+      vvp_net_compact_fanout();
+
       if (verbose_flag) {
 	    fprintf(stderr, " ... Compiletf functions\n");
 	    fflush(stderr);
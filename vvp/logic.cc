@@ -724,6 +724,9 @@ void compile_functor(char*label, char*type, unsigned width,
       inputs_connect(net, argc, argv);
       free(argv);
 
+      if (schedule_levelize_flag)
+	    schedule_levelize_net(net);
+
 	/* If both the strengths are the default strong drive, then
 	   there is no need for a specialized driver. Attach the label
 	   to this node and we are finished. */
@@ -26,7 +26,7 @@
 /*
  * vvp_fun_boolean_ is just a common hook for holding operands.
  */
-class vvp_fun_boolean_ : public vvp_net_fun_t, protected vvp_gen_event_s {
+class vvp_fun_boolean_ : public vvp_net_fun_t, public vvp_gen_event_s {
 
     public:
       explicit vvp_fun_boolean_(unsigned wid);
@@ -80,7 +80,7 @@ class vvp_fun_impl : public vvp_fun_boolean_ {
  * The retransmitted vector has all Z values changed to X, just like
  * the buf(Q,D) gate in Verilog.
  */
-class vvp_fun_buf: public vvp_net_fun_t, private vvp_gen_event_s {
+class vvp_fun_buf: public vvp_net_fun_t, public vvp_gen_event_s {
 
     public:
       explicit vvp_fun_buf(unsigned wid);
@@ -146,7 +146,7 @@ enum sel_type {SEL_PORT0, SEL_PORT1, SEL_BOTH};
  * input (port-0 or port-1) to enter the device. The narrow vector is
  * padded with X values.
  */
-class vvp_fun_muxz : public vvp_net_fun_t, private vvp_gen_event_s {
+class vvp_fun_muxz : public vvp_net_fun_t, public vvp_gen_event_s {
 
     public:
       explicit vvp_fun_muxz(unsigned width);
@@ -169,7 +169,7 @@ class vvp_fun_muxz : public vvp_net_fun_t, private vvp_gen_event_s {
       bool has_run_;
 };
 
-class vvp_fun_muxr : public vvp_net_fun_t, private vvp_gen_event_s {
+class vvp_fun_muxr : public vvp_net_fun_t, public vvp_gen_event_s {
 
     public:
       explicit vvp_fun_muxr();
@@ -190,7 +190,7 @@ class vvp_fun_muxr : public vvp_net_fun_t, private vvp_gen_event_s {
       sel_type select_;
 };
 
-class vvp_fun_not: public vvp_net_fun_t, private vvp_gen_event_s {
+class vvp_fun_not: public vvp_net_fun_t, public vvp_gen_event_s {
 
     public:
       explicit vvp_fun_not(unsigned wid);
@@ -25,6 +25,7 @@
 # include  "schedule.h"
 # include  "vpi_priv.h"
 # include  "statistics.h"
+# include  "profile.h"
 # include  "vvp_cleanup.h"
 # include  "vvp_object.h"
 # include  <cstdio>
@@ -217,7 +218,6 @@ static void final_cleanup()
       root_table_delete();
       def_table_delete();
       vpi_mcd_delete();
-      dec_str_delete();
       modpath_delete();
       vpi_handle_delete();
       vpi_stack_delete();
@@ -248,6 +248,7 @@ unsigned module_cnt = 0;
 const char*module_tab[64];
 
 extern void vpip_mcd_init(FILE *log);
+extern size_t vpip_file_buffer_size;
 extern void vvp_vpi_init(void);
 
 int main(int argc, char*argv[])
@@ -257,6 +258,7 @@ int main(int argc, char*argv[])
       const char*design_path = 0;
       struct rusage cycles[3];
       const char *logfile_name = 0x0;
+      const char *profile_path = 0x0;
       FILE *logfile = 0x0;
       extern void vpi_set_vlog_info(int, char**);
       extern bool stop_is_finish;
@@ -278,7 +280,7 @@ int main(int argc, char*argv[])
         /* For non-interactive runs we do not want to run the interactive
          * debugger, so make $stop just execute a $finish. */
       stop_is_finish = false;
-      while ((opt = getopt(argc, argv, "+hil:M:m:nNsvV")) != EOF) switch (opt) {
+      while ((opt = getopt(argc, argv, "+hil:M:m:nNP:svV")) != EOF) switch (opt) {
          case 'h':
            fprintf(stderr,
                    "Usage: vvp [options] input-file [+plusargs...]\n"
@@ -291,6 +293,7 @@ int main(int argc, char*argv[])
                    " -m module      Load vpi module.\n"
 		   " -n             Non-interactive ($stop = $finish).\n"
                    " -N             Same as -n, but exit code is 1 instead of 0\n"
+                   " -P file        Write an execution profile to file.\n"
 		   " -s             $stop right away.\n"
                    " -v             Verbose progress messages.\n"
                    " -V             Print the version information.\n" );
@@ -318,6 +321,9 @@ int main(int argc, char*argv[])
             stop_is_finish = true;
             stop_is_finish_exit_code = 1;
             break;
+	  case 'P':
+	    profile_path = optarg;
+	    break;
 	  case 's':
 	    schedule_stop(0);
 	    break;
@@ -370,6 +376,37 @@ int main(int argc, char*argv[])
 	    debug_file.open(path, ios::out);
       }
 
+	/* The VVP_SPARSE_ARRAY_THRESHOLD variable sets the size in
+	   bytes above which memories are allocated sparsely. */
+      if (const char*val = getenv("VVP_SPARSE_ARRAY_THRESHOLD")) {
+	    vvp_sparse_array_threshold = strtoul(val, 0, 0);
+      }
+
+	/* The VVP_FANOUT_COMPACT_THRESHOLD variable sets the number
+	   of inputs a net output must drive before its fan-out is
+	   compacted into an array. */
+      if (const char*val = getenv("VVP_FANOUT_COMPACT_THRESHOLD")) {
+	    vvp_fanout_compact_threshold = strtoul(val, 0, 0);
+      }
+
+	/* The VVP_FANOUT_COMPACT_SORT variable groups the compacted
+	   fan-out destinations by functor type. */
+      if (const char*val = getenv("VVP_FANOUT_COMPACT_SORT")) {
+	    vvp_fanout_compact_sort = strcmp(val, "0") != 0;
+      }
+
+	/* The VVP_FILE_BUFFER_SIZE variable sets the stdio buffer
+	   size for files opened for writing by the simulation. */
+      if (const char*val = getenv("VVP_FILE_BUFFER_SIZE")) {
+	    vpip_file_buffer_size = strtoul(val, 0, 0);
+      }
+
+	/* The VVP_LEVELIZE variable turns on levelized evaluation of
+	   the combinational logic gates. */
+      if (const char*val = getenv("VVP_LEVELIZE")) {
+	    schedule_levelize_flag = strcmp(val, "0") != 0;
+      }
+
       design_path = argv[optind];
 
 	/* This is needed to get the MCD I/O routines ready for
@@ -430,10 +467,23 @@ int main(int argc, char*argv[])
 	    return compile_errors;
       }
 
+      if (profile_path) {
+	    if (! profile_open(profile_path)) {
+		  vpi_mcd_printf(1, "%s: Unable to open profile file.\n",
+				 profile_path);
+	    } else {
+		  profile_attach_nets();
+	    }
+      }
+
       if (verbose_flag) {
 	    vpi_mcd_printf(1, " ... %8lu functors (net_fun pool=%zu bytes)\n",
 			   count_functors, vvp_net_fun_t::heap_total());
 	    vpi_mcd_printf(1, "           %8lu logic\n",  count_functors_logic);
+	    if (schedule_levelize_flag)
+		  vpi_mcd_printf(1, "           %8lu levelized (%lu levels)\n",
+				 count_functors_levelized,
+				 count_levelize_levels);
 	    vpi_mcd_printf(1, "           %8lu bufif\n",  count_functors_bufif);
 	    vpi_mcd_printf(1, "           %8lu resolv\n",count_functors_resolv);
 	    vpi_mcd_printf(1, "           %8lu signals\n", count_functors_sig);
@@ -444,6 +494,8 @@ int main(int argc, char*argv[])
 	    vpi_mcd_printf(1, " ... %8lu nets\n",     count_vpi_nets);
 	    vpi_mcd_printf(1, " ... %8lu vvp_nets (%zu bytes)\n",
 			   count_vvp_nets, size_vvp_nets);
+	    vpi_mcd_printf(1, "           %8lu compacted fan-outs\n",
+			   count_fanout_compacted);
 	    vpi_mcd_printf(1, " ... %8lu arrays (%lu words)\n",
 			   count_net_arrays, count_net_array_words);
 	    vpi_mcd_printf(1, " ... %8lu memories\n",
@@ -452,6 +504,10 @@ int main(int argc, char*argv[])
 			   count_var_arrays, count_var_array_words);
 	    vpi_mcd_printf(1, "           %8lu real (%lu words)\n",
 			   count_real_arrays, count_real_array_words);
+	    vpi_mcd_printf(1, "           %8zu/%zu KBytes logic storage "
+			   "resident/logical\n",
+			   size_var_array_resident/1024,
+			   size_var_array_logical/1024);
 	    vpi_mcd_printf(1, " ... %8lu scopes\n",   count_vpi_scopes);
       }
 
@@ -464,6 +520,8 @@ int main(int argc, char*argv[])
 
       schedule_simulate();
 
+      profile_close();
+
       if (verbose_flag) {
 	    my_getrusage(cycles+2);
 	    print_rusage(cycles+2, cycles+1);
@@ -473,8 +531,8 @@ int main(int argc, char*argv[])
 			   count_time_events, count_time_pool());
 	    vpi_mcd_printf(1, "    %8lu thread schedule events\n",
 		    count_thread_events);
-	    vpi_mcd_printf(1, "    %8lu assign events\n",
-		    count_assign_events);
+	    vpi_mcd_printf(1, "    %8lu assign events (%lu batches)\n",
+		    count_assign_events, count_assign_batches);
 	    vpi_mcd_printf(1, "             ...assign(vec4) pool=%lu\n",
 			   count_assign4_pool());
 	    vpi_mcd_printf(1, "             ...assign(vec8) pool=%lu\n",
@@ -487,6 +545,10 @@ int main(int argc, char*argv[])
 			   count_assign_arword_pool());
 	    vpi_mcd_printf(1, "    %8lu other events (pool=%lu)\n",
 			   count_gen_events, count_gen_pool());
+	    vpi_mcd_printf(1, "Memory storage: %zu/%zu KBytes "
+			   "resident/logical\n",
+			   size_var_array_resident/1024,
+			   size_var_array_logical/1024);
       }
 
       final_cleanup();
@@ -25,6 +25,7 @@
 # include  <list>
 # include  <cstdio>
 # include  <cstdlib>
+# include  <cstring>
 # include  <cassert>
 # include  "ivl_alloc.h"
 # include  "version_base.h"
@@ -1249,13 +1250,27 @@ int compile_design(const char*path)
 {
       yypath = path;
       yyline = 1;
-      yyin = fopen(path, "r");
-      if (yyin == 0) {
-	    fprintf(stderr, "%s: Unable to open input file.\n", path);
-	    return -1;
+
+	/* An input path of "-" reads the design from stdin, so that
+	   the code generator output can be piped in directly. */
+      bool use_stdin = strcmp(path, "-") == 0;
+      if (use_stdin) {
+	    yyin = stdin;
+      } else {
+	    yyin = fopen(path, "r");
+	    if (yyin == 0) {
+		  fprintf(stderr, "%s: Unable to open input file.\n", path);
+		  return -1;
+	    }
+	      /* The lexor reads the whole file once, so a large
+		 buffer saves read calls on big designs. The buffer
+		 of stdin is left alone, since setvbuf is only valid
+		 before the first I/O on a stream. */
+	    setvbuf(yyin, 0, _IOFBF, 256*1024);
       }
 
       int rc = yyparse();
-      fclose(yyin);
+      if (! use_stdin)
+	    fclose(yyin);
       return rc;
 }
@@ -420,6 +420,12 @@ void link_node_1(char*label, char*source, vvp_net_fun_t*fun)
       free(label);
 
       input_connect(net, 0, source);
+
+	/* A static part select defers its output through
+	   schedule_functor() like a logic gate, so it can be
+	   levelized with the gates. */
+      if (schedule_levelize_flag)
+	    schedule_levelize_net(net);
 }
 
 void compile_part_select(char*label, char*source,
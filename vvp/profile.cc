@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2026 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+# include  "profile.h"
+# include  "compile.h"
+# include  "vpi_priv.h"
+# include  "vvp_net.h"
+# include  <cstdio>
+# include  <map>
+# include  <string>
+# include  <utility>
+# include  <vector>
+#ifdef CHECK_WITH_VALGRIND
+# include  "vvp_cleanup.h"
+#endif
+
+using namespace std;
+
+bool profile_flag = false;
+
+static FILE*profile_file = 0;
+
+typedef pair<__vpiScope*,vpiHandle> scope_line_t;
+static map<scope_line_t,unsigned long> opcode_counts;
+
+/*
+ * The opcode mix is counted for every instruction, so it is kept in a
+ * flat open addressed table keyed by the opcode function instead of a
+ * map. There are a few hundred opcodes, so the table is never more
+ * than about a quarter full and a lookup almost always hits the first
+ * slot it tries. The names are looked up only for the report.
+ */
+struct opcode_mix_s {
+      vvp_code_fun opcode;
+      unsigned long count;
+};
+static const size_t opcode_mix_size = 1024;
+static opcode_mix_s opcode_mix[opcode_mix_size];
+
+/*
+ * The net probe is linked to the output of a signal, so it receives
+ * every value that the signal propagates. It only counts them.
+ */
+class vvp_fun_profile_probe : public vvp_net_fun_t {
+
+    public:
+      vvp_fun_profile_probe() : count(0) { }
+
+      void recv_vec4(vvp_net_ptr_t, const vvp_vector4_t&, vvp_context_t)
+      { count += 1; }
+      void recv_vec8(vvp_net_ptr_t, const vvp_vector8_t&)
+      { count += 1; }
+      void recv_real(vvp_net_ptr_t, double, vvp_context_t)
+      { count += 1; }
+      void recv_long(vvp_net_ptr_t, long)
+      { count += 1; }
+      void recv_string(vvp_net_ptr_t, const std::string&, vvp_context_t)
+      { count += 1; }
+      void recv_object(vvp_net_ptr_t, vvp_object_t, vvp_context_t)
+      { count += 1; }
+      void recv_vec4_pv(vvp_net_ptr_t, const vvp_vector4_t&,
+			unsigned, unsigned, unsigned, vvp_context_t)
+      { count += 1; }
+      void recv_vec8_pv(vvp_net_ptr_t, const vvp_vector8_t&,
+			unsigned, unsigned, unsigned)
+      { count += 1; }
+      void recv_long_pv(vvp_net_ptr_t, long, unsigned, unsigned)
+      { count += 1; }
+
+      unsigned long count;
+};
+
+struct net_probe_s {
+      __vpiScope*scope;
+      const char*name;
+      vvp_fun_profile_probe*probe;
+};
+static vector<net_probe_s> net_probes;
+
+bool profile_open(const char*path)
+{
+      profile_file = fopen(path, "w");
+      if (profile_file == 0)
+	    return false;
+
+      profile_flag = true;
+      return true;
+}
+
+static void attach_scope_nets(__vpiScope*scope)
+{
+	// Automatic scopes hold only the templates of their items.
+      if (scope->is_automatic())
+	    return;
+
+      for (unsigned idx = 0 ; idx < scope->intern.size() ; idx += 1) {
+	    vpiHandle item = scope->intern[idx];
+	    if (__vpiScope*sub = dynamic_cast<__vpiScope*>(item)) {
+		  attach_scope_nets(sub);
+		  continue;
+	    }
+
+	    __vpiSignal*sig = dynamic_cast<__vpiSignal*>(item);
+	    if (sig == 0 || sig->node == 0)
+		  continue;
+
+	    net_probe_s cur;
+	    cur.scope = scope;
+	    cur.name  = sig->id.name;
+	    cur.probe = new vvp_fun_profile_probe;
+
+	    vvp_net_t*net = new vvp_net_t;
+	    net->fun = cur.probe;
+	    sig->node->link(vvp_net_ptr_t(net, 0));
+#ifdef CHECK_WITH_VALGRIND
+	    pool_local_net(net);
+#endif
+	    net_probes.push_back(cur);
+      }
+}
+
+void profile_attach_nets(void)
+{
+      __vpiHandle**roots;
+      unsigned nroots;
+      vpip_make_root_iterator(roots, nroots);
+      for (unsigned idx = 0 ; idx < nroots ; idx += 1) {
+	    if (__vpiScope*scope = dynamic_cast<__vpiScope*>(roots[idx]))
+		  attach_scope_nets(scope);
+      }
+}
+
+void profile_count_opcodes(__vpiScope*scope, vpiHandle line,
+			   unsigned long count)
+{
+      if (count == 0)
+	    return;
+
+      opcode_counts[scope_line_t(scope,line)] += count;
+}
+
+void profile_count_opcode(vvp_code_fun opcode)
+{
+      size_t idx = (reinterpret_cast<size_t>(opcode) >> 4) % opcode_mix_size;
+      while (opcode_mix[idx].opcode != opcode) {
+	    if (opcode_mix[idx].opcode == 0) {
+		  opcode_mix[idx].opcode = opcode;
+		  break;
+	    }
+	    idx = (idx + 1) % opcode_mix_size;
+      }
+      opcode_mix[idx].count += 1;
+}
+
+static void print_scope_frames(__vpiScope*scope)
+{
+      if (scope == 0)
+	    return;
+
+      print_scope_frames(scope->scope);
+      fprintf(profile_file, ";%s", scope->scope_name());
+}
+
+void profile_close(void)
+{
+      if (profile_file == 0)
+	    return;
+
+      for (map<scope_line_t,unsigned long>::const_iterator cur
+		 = opcode_counts.begin()
+		 ; cur != opcode_counts.end() ; ++ cur) {
+	    fprintf(profile_file, "opcodes");
+	    print_scope_frames(cur->first.first);
+	    if (vpiHandle line = cur->first.second) {
+		  fprintf(profile_file, ";%s:%d",
+			  vpi_get_str(vpiFile, line),
+			  vpi_get(vpiLineNo, line));
+	    }
+	    fprintf(profile_file, " %lu\n", cur->second);
+      }
+
+      for (size_t idx = 0 ; idx < opcode_mix_size ; idx += 1) {
+	    const opcode_mix_s&cur = opcode_mix[idx];
+	    if (cur.opcode == 0)
+		  continue;
+	    const char*name = compile_opcode_name(cur.opcode);
+	    fprintf(profile_file, "opcode-mix;%s %lu\n",
+		    name? name : "<internal>", cur.count);
+      }
+
+      for (size_t idx = 0 ; idx < net_probes.size() ; idx += 1) {
+	    const net_probe_s&cur = net_probes[idx];
+	    if (cur.probe->count == 0)
+		  continue;
+	    fprintf(profile_file, "net-updates");
+	    print_scope_frames(cur.scope);
+	    fprintf(profile_file, ";%s %lu\n", cur.name, cur.probe->count);
+      }
+
+      fclose(profile_file);
+      profile_file = 0;
+      profile_flag = false;
+}
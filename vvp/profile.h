@@ -0,0 +1,61 @@
+#ifndef IVL_profile_H
+#define IVL_profile_H
+/*
+ * Copyright (c) 2026 Stephen Williams (steve@icarus.com)
+ *
+ *    This source code is free software; you can redistribute it
+ *    and/or modify it in source code form under the terms of the GNU
+ *    General Public License as published by the Free Software
+ *    Foundation; either version 2 of the License, or (at your option)
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+# include  "codes.h"
+# include  "vpi_user.h"
+
+class __vpiScope;
+
+/*
+ * The profiler is enabled by the -P <path> flag. It counts:
+ *
+ *   - the opcodes executed by threads, by scope and, if the code was
+ *     compiled with %file_line instrumentation, by source line,
+ *
+ *   - the opcodes executed, by opcode,
+ *
+ *   - the values propagated out of each (static) signal, using a
+ *     counting probe linked to the output of the signal.
+ *
+ * The report is written in the "folded stacks" format that flame
+ * graph tools read: one line per stack, with the frames separated
+ * by ';', followed by a space and the count. The first frame of
+ * each line is "opcodes", "opcode-mix" or "net-updates".
+ */
+extern bool profile_flag;
+
+  // Open the report file. Return false if that fails.
+extern bool profile_open(const char*path);
+
+  // Link counting probes to the signals. Call after compile.
+extern void profile_attach_nets(void);
+
+  // Account count opcodes to the scope and %file_line handle.
+extern void profile_count_opcodes(__vpiScope*scope, vpiHandle line,
+				  unsigned long count);
+
+  // Account one execution of the opcode.
+extern void profile_count_opcode(vvp_code_fun opcode);
+
+  // Write the report and close the file.
+extern void profile_close(void);
+
+#endif /* IVL_profile_H */
@@ -72,16 +72,13 @@ void resolv_core::recv_vec8_pv_(unsigned port, const vvp_vector8_t&bit,
 				unsigned base, unsigned wid, unsigned vwid)
 {
       assert(bit.size() == wid);
+	// A new vector8 is all HiZ, so only the part needs copying.
       vvp_vector8_t res (vwid);
 
-      for (unsigned idx = 0 ;  idx < base ;  idx += 1)
-	    res.set_bit(idx, vvp_scalar_t());
-
-      for (unsigned idx = 0 ;  idx < wid && idx+base < vwid;  idx += 1)
-	    res.set_bit(idx+base, bit.value(idx));
-
-      for (unsigned idx = base+wid ;  idx < vwid ;  idx += 1)
-	    res.set_bit(idx, vvp_scalar_t());
+      if (base+wid <= vwid)
+	    res.set_vec(base, bit);
+      else if (base < vwid)
+	    res.set_vec(base, bit.subvalue(0, vwid-base));
 
       recv_vec8_(port, res);
 }
@@ -24,18 +24,23 @@
 # include  "vvp_net_sig.h"
 # include  "slab.h"
 # include  "compile.h"
+# include  "statistics.h"
 # include  <new>
 # include  <typeinfo>
 # include  <csignal>
 # include  <cstdlib>
 # include  <cassert>
 # include  <iostream>
+# include  <map>
+# include  <set>
+# include  <vector>
 #ifdef CHECK_WITH_VALGRIND
 # include  "vvp_cleanup.h"
 # include  "ivl_alloc.h"
 #endif
 
 unsigned long count_assign_events = 0;
+unsigned long count_assign_batches = 0;
 unsigned long count_gen_events = 0;
 unsigned long count_thread_events = 0;
   // Count the time events (A time cell created)
@@ -294,6 +299,8 @@ void assign_real_event_s::operator delete(void*dptr)
 unsigned long count_assign_real_pool(void) { return assignr_heap.pool; }
 
 struct assign_array_word_s  : public event_s {
+      explicit assign_array_word_s(const vvp_vector4_t&that) : val(that) { }
+
       vvp_array_t mem;
       unsigned adr;
       vvp_vector4_t val;
@@ -326,6 +333,115 @@ void assign_array_word_s::operator delete(void*ptr)
 
 unsigned long count_assign_aword_pool(void) { return array_w_heap.pool; }
 
+/*
+ * The zero delay non-blocking assignments of vectors to nets and to
+ * array words are collected into batch events instead of getting an
+ * event each. A batch keeps its assignments in two parallel arrays,
+ * the destinations and the values, in the order they were scheduled,
+ * and applies them all in one pass when it reaches the head of the
+ * active queue. Nothing that the assignments trigger can run before
+ * the rest of the nbassign queue anyway, since it is scheduled behind
+ * it, so this is the same as running them as separate events.
+ *
+ * A new assignment joins the batch only if the batch is still the
+ * tail of the nbassign queue of the current time step. Otherwise (an
+ * event of some other kind was scheduled after it, or the queue was
+ * moved to the active queue) a new batch is started, so the order of
+ * all the nbassign events is kept.
+ *
+ * The arrays of a finished batch are kept for the next one, so in
+ * steady state a batch only allocates the values that do not fit in
+ * a vvp_vector4_t.
+ */
+struct assign_vector4_batch_s  : public event_s {
+	/* The destination of one assignment. If mem is nil, this is a
+	   net and ptr, base and vwid are as in assign_vector4_event_s,
+	   otherwise this is word adr of mem, at offset base. */
+      struct dest_s {
+	    vvp_net_ptr_t ptr;
+	    vvp_array_t mem;
+	    unsigned adr;
+	    unsigned base;
+	    unsigned vwid;
+      };
+
+      assign_vector4_batch_s();
+      ~assign_vector4_batch_s();
+
+      std::vector<dest_s> dest;
+      std::vector<vvp_vector4_t> val;
+
+      void run_run(void);
+      void single_step_display(void);
+
+      static void* operator new(size_t);
+      static void operator delete(void*);
+};
+
+  // The batch that new assignments can join, if it is still the tail
+  // of the current nbassign queue. This is cleared when the batch runs.
+static assign_vector4_batch_s*nb_batch = 0;
+  // The arrays of the last batch that was deleted.
+static std::vector<assign_vector4_batch_s::dest_s> nb_batch_dest;
+static std::vector<vvp_vector4_t> nb_batch_val;
+
+assign_vector4_batch_s::assign_vector4_batch_s()
+{
+      count_assign_batches += 1;
+      dest.swap(nb_batch_dest);
+      val.swap(nb_batch_val);
+}
+
+assign_vector4_batch_s::~assign_vector4_batch_s()
+{
+      if (nb_batch == this)
+	    nb_batch = 0;
+      dest.clear();
+      val.clear();
+      if (dest.capacity() > nb_batch_dest.capacity()) {
+	    dest.swap(nb_batch_dest);
+	    val.swap(nb_batch_val);
+      }
+}
+
+void assign_vector4_batch_s::run_run(void)
+{
+      if (nb_batch == this)
+	    nb_batch = 0;
+
+      count_assign_events += dest.size();
+      for (size_t idx = 0 ; idx < dest.size() ; idx += 1) {
+	    const dest_s&cur = dest[idx];
+	    if (cur.mem)
+		  cur.mem->set_word(cur.adr, cur.base, val[idx]);
+	    else if (cur.vwid > 0)
+		  vvp_send_vec4_pv(cur.ptr, val[idx], cur.base,
+				   val[idx].size(), cur.vwid, 0);
+	    else
+		  vvp_send_vec4(cur.ptr, val[idx], 0);
+      }
+}
+
+void assign_vector4_batch_s::single_step_display(void)
+{
+      cerr << "assign_vector4_batch: Propagate " << dest.size()
+	   << " assignments" << endl;
+}
+
+static const size_t ASSIGN4_BATCH_CHUNK_COUNT = 8192 / sizeof(struct assign_vector4_batch_s);
+static slab_t<sizeof(assign_vector4_batch_s),ASSIGN4_BATCH_CHUNK_COUNT> assign4_batch_heap;
+
+inline void* assign_vector4_batch_s::operator new(size_t size)
+{
+      assert(size == sizeof(assign_vector4_batch_s));
+      return assign4_batch_heap.alloc_slab();
+}
+
+void assign_vector4_batch_s::operator delete(void*dptr)
+{
+      assign4_batch_heap.free_slab(dptr);
+}
+
 struct force_vector4_event_s  : public event_s {
 	/* The default constructor. */
       explicit force_vector4_event_s(const vvp_vector4_t&that): val(that) {
@@ -857,11 +973,41 @@ void schedule_final_vthread(vthread_t thr)
       schedule_final_event(cur);
 }
 
+/*
+ * Get the batch that a zero delay assignment joins, starting a new
+ * one if the current batch is no longer the tail of the nbassign
+ * queue of the current time step.
+ */
+static assign_vector4_batch_s* nb_batch_tail_(void)
+{
+      if (nb_batch && sched_list && sched_list->delay == 0
+	  && sched_list->nbassign == nb_batch)
+	    return nb_batch;
+
+      assign_vector4_batch_s*cur = new assign_vector4_batch_s;
+      schedule_event_(cur, 0, SEQ_NBASSIGN);
+      nb_batch = cur;
+      return cur;
+}
+
 void schedule_assign_vector(vvp_net_ptr_t ptr,
 			    unsigned base, unsigned vwid,
 			    const vvp_vector4_t&bit,
 			    vvp_time64_t delay)
 {
+      if (delay == 0) {
+	    assign_vector4_batch_s*batch = nb_batch_tail_();
+	    assign_vector4_batch_s::dest_s dest;
+	    dest.ptr = ptr;
+	    dest.mem = 0;
+	    dest.adr = 0;
+	    dest.base = base;
+	    dest.vwid = vwid;
+	    batch->dest.push_back(dest);
+	    batch->val.push_back(bit);
+	    return;
+      }
+
       struct assign_vector4_event_s*cur = new struct assign_vector4_event_s(bit);
       cur->ptr = ptr;
       cur->base = base;
@@ -894,14 +1040,25 @@ void schedule_propagate_vector(vvp_net_t*net,
 void schedule_assign_array_word(vvp_array_t mem,
 				unsigned word_addr,
 				unsigned off,
-				vvp_vector4_t val,
+				const vvp_vector4_t&val,
 				vvp_time64_t delay)
 {
-      struct assign_array_word_s*cur = new struct assign_array_word_s;
+      if (delay == 0) {
+	    assign_vector4_batch_s*batch = nb_batch_tail_();
+	    assign_vector4_batch_s::dest_s dest;
+	    dest.mem = mem;
+	    dest.adr = word_addr;
+	    dest.base = off;
+	    dest.vwid = 0;
+	    batch->dest.push_back(dest);
+	    batch->val.push_back(val);
+	    return;
+      }
+
+      struct assign_array_word_s*cur = new struct assign_array_word_s(val);
       cur->mem = mem;
       cur->adr = word_addr;
       cur->off = off;
-      cur->val = val;
       schedule_event_(cur, delay, SEQ_NBASSIGN);
 }
 
@@ -1007,8 +1164,180 @@ void schedule_generic(vvp_gen_event_t obj, vvp_time64_t delay,
 
 static bool sim_started;
 
+/*
+ * Levelized gates are not scheduled individually. They are collected
+ * in buckets by level (and within a level by gate type), and a single
+ * active event (the level_drain) runs the buckets in increasing
+ * order. A gate that is scheduled while its own or a lower level is
+ * running is left for the next pass of the drain, which is
+ * rescheduled at the end of the active queue so that it does not
+ * starve the other active events.
+ */
+bool schedule_levelize_flag = false;
+
+static vector<vvp_net_t*> levelize_nets;
+static vector< vector<vvp_gen_event_t> > level_buckets;
+static vector<vvp_gen_event_t> level_running;
+static unsigned long level_pending = 0;
+static bool level_drain_armed = false;
+
+static struct level_drain_s : public vvp_gen_event_s {
+      void run_run(void);
+} level_drain;
+
+static void schedule_level_drain_(void)
+{
+      struct generic_event_s*cur = new generic_event_s;
+      cur->obj = &level_drain;
+      cur->delete_obj_when_done = false;
+      schedule_event_(cur, 0, SEQ_ACTIVE);
+}
+
+void level_drain_s::run_run(void)
+{
+      for (unsigned lev = 1 ; lev < level_buckets.size() ; lev += 1) {
+	    if (level_buckets[lev].empty())
+		  continue;
+
+	    level_running.swap(level_buckets[lev]);
+	    for (size_t idx = 0 ; idx < level_running.size() ; idx += 1) {
+		  level_pending -= 1;
+		  count_gen_events += 1;
+		  level_running[idx]->run_run();
+	    }
+	    level_running.clear();
+      }
+
+      if (level_pending > 0)
+	    schedule_level_drain_();
+      else
+	    level_drain_armed = false;
+}
+
+void schedule_levelize_net(vvp_net_t*net)
+{
+      if (dynamic_cast<vvp_gen_event_t>(net->fun))
+	    levelize_nets.push_back(net);
+}
+
+/*
+ * The walk from a gate output to the gates that it drives passes
+ * through all the intervening nodes (signals, drivers, part selects,
+ * etc.) The walk is cut off after this many nodes. A missing edge
+ * only costs extra evaluations, never correctness, as the order of
+ * active events is arbitrary anyhow.
+ */
+static const size_t LEVELIZE_WALK_LIMIT = 4096;
+
+void schedule_levelize(void)
+{
+      const size_t ngates = levelize_nets.size();
+
+      map<vvp_net_t*,unsigned> gate_index;
+      for (unsigned idx = 0 ; idx < ngates ; idx += 1)
+	    gate_index[levelize_nets[idx]] = idx;
+
+	// Collect the gate to gate edges.
+      vector< vector<unsigned> > succ (ngates);
+      vector<unsigned> indeg (ngates, 0);
+      for (unsigned idx = 0 ; idx < ngates ; idx += 1) {
+	    set<vvp_net_t*> seen;
+	    vector<vvp_net_t*> todo;
+	    todo.push_back(levelize_nets[idx]);
+	    while (! todo.empty()) {
+		  vvp_net_t*net = todo.back();
+		  todo.pop_back();
+
+		  vvp_net_ptr_t cur = net->fanout();
+		  while (vvp_net_t*dst = cur.ptr()) {
+			cur = dst->port[cur.port()];
+			if (! seen.insert(dst).second)
+			      continue;
+
+			map<vvp_net_t*,unsigned>::const_iterator gate
+			      = gate_index.find(dst);
+			if (gate != gate_index.end()) {
+			      succ[idx].push_back(gate->second);
+			      indeg[gate->second] += 1;
+			} else if (seen.size() < LEVELIZE_WALK_LIMIT) {
+			      todo.push_back(dst);
+			}
+		  }
+	    }
+      }
+
+	// Rank the gates by longest path from the gates with no gate
+	// inputs. Gates in or behind loops never become ready, so
+	// they keep level 0 and are scheduled as usual.
+      vector<unsigned> level (ngates, 1);
+      vector<unsigned> ready;
+      for (unsigned idx = 0 ; idx < ngates ; idx += 1) {
+	    if (indeg[idx] == 0)
+		  ready.push_back(idx);
+      }
+
+      unsigned max_level = 0;
+      while (! ready.empty()) {
+	    unsigned cur = ready.back();
+	    ready.pop_back();
+
+	    vvp_gen_event_t obj = dynamic_cast<vvp_gen_event_t>(levelize_nets[cur]->fun);
+	    obj->sched_level = level[cur];
+	    count_functors_levelized += 1;
+	    if (level[cur] > max_level)
+		  max_level = level[cur];
+
+	    for (size_t idx = 0 ; idx < succ[cur].size() ; idx += 1) {
+		  unsigned dst = succ[cur][idx];
+		  if (level[dst] <= level[cur])
+			level[dst] = level[cur] + 1;
+		  indeg[dst] -= 1;
+		  if (indeg[dst] == 0)
+			ready.push_back(dst);
+	    }
+      }
+
+	// Split each level into one bucket per gate type, so that the
+	// drain runs the same run_run method for a whole bucket and
+	// the indirect calls are well predicted.
+      vector<const type_info*> types;
+      vector<unsigned> type_rank (ngates);
+      for (unsigned idx = 0 ; idx < ngates ; idx += 1) {
+	    const type_info*type = &typeid(*levelize_nets[idx]->fun);
+	    unsigned rank = 0;
+	    while (rank < types.size() && *types[rank] != *type)
+		  rank += 1;
+	    if (rank == types.size())
+		  types.push_back(type);
+	    type_rank[idx] = rank;
+      }
+
+      const unsigned ntypes = types.size();
+      for (unsigned idx = 0 ; idx < ngates ; idx += 1) {
+	    vvp_gen_event_t obj = dynamic_cast<vvp_gen_event_t>(levelize_nets[idx]->fun);
+	    if (obj->sched_level == 0)
+		  continue;
+	    obj->sched_level = (obj->sched_level-1)*ntypes + type_rank[idx] + 1;
+      }
+
+      count_levelize_levels = max_level;
+      level_buckets.resize(max_level*ntypes + 1);
+
+      vector<vvp_net_t*>().swap(levelize_nets);
+}
+
 void schedule_functor(vvp_gen_event_t obj)
 {
+      if (obj->sched_level && sim_started) {
+	    level_buckets[obj->sched_level].push_back(obj);
+	    level_pending += 1;
+	    if (! level_drain_armed) {
+		  level_drain_armed = true;
+		  schedule_level_drain_();
+	    }
+	    return;
+      }
+
       struct generic_event_s*cur = new generic_event_s;
 
       cur->obj = obj;
@@ -46,6 +46,10 @@ extern void schedule_final_vthread(vthread_t thr);
  * the specified input when the delay times out. This is scheduled
  * like a non-blocking assignment. This is in fact mostly used to
  * implement the non-blocking assignment.
+ *
+ * The zero delay assignments of a time step are collected into batch
+ * events, in the order they are scheduled, instead of getting an
+ * event each.
  */
 extern void schedule_assign_vector(vvp_net_ptr_t ptr,
 				   unsigned base, unsigned vwid,
@@ -55,7 +59,7 @@ extern void schedule_assign_vector(vvp_net_ptr_t ptr,
 extern void schedule_assign_array_word(vvp_array_t mem,
 				       unsigned word_address,
 				       unsigned off,
-				       vvp_vector4_t val,
+				       const vvp_vector4_t&val,
 				       vvp_time64_t delay);
 
 extern void schedule_assign_array_word(vvp_array_t mem,
@@ -155,11 +159,41 @@ extern void schedule_del_thr(vthread_t thr);
 
 struct vvp_gen_event_s
 {
+      vvp_gen_event_s() : sched_level(0) { }
       virtual ~vvp_gen_event_s() =0;
       virtual void run_run() =0;
       virtual void single_step_display(void);
+
+	// Bucket (topological level and gate type) assigned by
+	// schedule_levelize(), or 0 if the object is not levelized.
+      unsigned sched_level;
 };
 
+/*
+ * Levelized evaluation of combinational gates. When the
+ * schedule_levelize_flag is set, the compiler registers the nets of
+ * logic gates with schedule_levelize_net(), and compile_cleanup()
+ * calls schedule_levelize() to rank the gates in topological order
+ * of their connections. From then on schedule_functor()
+ * collects the levelized gates in per-level, per-type buckets that are
+ * evaluated in level order by a single active event, so a gate at
+ * the end of reconvergent paths is evaluated once after all its
+ * inputs have settled instead of once per input change. Gates in or
+ * behind combinational loops are left unlevelized and are
+ * scheduled as usual.
+ *
+ * The "gates" are the functors that defer their output through
+ * schedule_functor(): the logic gates and muxes of .functor, static
+ * part selects and UDPs. The other functors (arithmetic, compares,
+ * concatenations, etc.) propagate their output as soon as an input
+ * changes, so they have no deferred evaluation to put in order. The
+ * ranking walks through them like through signals to find the gates
+ * that they lead to.
+ */
+extern bool schedule_levelize_flag;
+extern void schedule_levelize_net(vvp_net_t*net);
+extern void schedule_levelize(void);
+
 /*
  * This runs the simulator. It runs until all the functors run out or
  * the simulation is otherwise finished.
@@ -205,6 +239,7 @@ extern void stop_handler(int rc);
  * These are event counters for the sake of performance measurements.
  */
 extern unsigned long count_assign_events;
+extern unsigned long count_assign_batches;
 extern unsigned long count_gen_events;
 extern unsigned long count_prop_events;
 extern unsigned long count_thread_events;
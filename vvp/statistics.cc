@@ -26,14 +26,20 @@ unsigned long count_opcodes = 0;
 
 unsigned long count_functors = 0;
 unsigned long count_functors_logic = 0;
+unsigned long count_functors_levelized = 0;
+unsigned long count_levelize_levels = 0;
 unsigned long count_functors_bufif = 0;
 unsigned long count_functors_resolv= 0;
 unsigned long count_functors_sig   = 0;
 
 unsigned long count_filters = 0;
+unsigned long count_fanout_compacted = 0;
 unsigned long count_vpi_nets = 0;
 
 unsigned long count_vpi_scopes = 0;
 
+size_t size_var_array_logical = 0;
+size_t size_var_array_resident = 0;
+
 size_t size_opcodes = 0;
 
@@ -29,11 +29,14 @@
 extern unsigned long count_opcodes;
 extern unsigned long count_functors;
 extern unsigned long count_functors_logic;
+extern unsigned long count_functors_levelized;
+extern unsigned long count_levelize_levels;
 extern unsigned long count_functors_bufif;
 extern unsigned long count_functors_resolv;
 extern unsigned long count_functors_sig;
 extern unsigned long count_filters;
 extern unsigned long count_vvp_nets;
+extern unsigned long count_fanout_compacted;
 extern unsigned long count_vpi_nets;
 extern unsigned long count_vpi_scopes;
 
@@ -49,6 +52,7 @@ extern unsigned long count_time_events;
 extern unsigned long count_time_pool(void);
 
 extern unsigned long count_assign_events;
+extern unsigned long count_assign_batches;
 extern unsigned long count_assign4_pool(void);
 extern unsigned long count_assign8_pool(void);
 extern unsigned long count_assign_real_pool(void);
@@ -58,6 +62,11 @@ extern unsigned long count_assign_arword_pool(void);
 extern unsigned long count_gen_events;
 extern unsigned long count_gen_pool(void);
 
+  // Bytes of storage needed by all the static logic arrays, and the
+  // bytes actually allocated for them so far.
+extern size_t size_var_array_logical;
+extern size_t size_var_array_resident;
+
 extern size_t size_opcodes;
 extern size_t size_vvp_nets;
 extern size_t size_vvp_net_funs;
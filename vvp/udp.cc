@@ -125,12 +125,14 @@ vvp_udp_comb_s::vvp_udp_comb_s(char*label, char*name__, unsigned ports)
       levels1_ = 0;
       nlevels0_ = 0;
       nlevels1_ = 0;
+      lookup_ = 0;
 }
 
 vvp_udp_comb_s::~vvp_udp_comb_s()
 {
       delete[] levels0_;
       delete[] levels1_;
+      delete[] lookup_;
 }
 
 /*
@@ -188,9 +190,51 @@ vvp_bit4_t vvp_udp_comb_s::calculate_output(const udp_levels_table&cur,
 					    const udp_levels_table&,
 					    vvp_bit4_t)
 {
+      if (lookup_)
+	    return (vvp_bit4_t) lookup_[cur.mask1 | (cur.maskx << port_count())];
+
       return test_levels(cur);
 }
 
+/*
+ * Devices with up to this many inputs get their rows expanded into
+ * a direct indexed truth table. Each table entry is a byte, and the
+ * table has 4**N entries for a combinational device. A sequential
+ * device also has the current output as a level, and one copy of the
+ * levels for each input and each of the 3 values that input may have
+ * changed from, so it has 3*N*4**(N+1) entries. The definition owns
+ * the table, so all the instances of a primitive share it.
+ */
+static const unsigned UDP_COMB_LOOKUP_PORTS = 7;
+static const unsigned UDP_SEQ_LOOKUP_PORTS = 4;
+
+void vvp_udp_comb_s::compile_lookup_()
+{
+      const unsigned nports = port_count();
+      if (nports > UDP_COMB_LOOKUP_PORTS)
+	    return;
+
+      const unsigned long port_mask = (1UL << nports) - 1;
+      const unsigned long nentries = 1UL << (2*nports);
+      lookup_ = new unsigned char[nentries];
+
+      for (unsigned long idx = 0 ;  idx < nentries ;  idx += 1) {
+	    udp_levels_table cur;
+	    cur.mask1 = idx & port_mask;
+	    cur.maskx = idx >> nports;
+	    cur.mask0 = port_mask & ~(cur.mask1 | cur.maskx);
+
+	      // An input cannot be both 1 and x, so these entries are
+	      // never used.
+	    if (cur.mask1 & cur.maskx) {
+		  lookup_[idx] = BIT4_X;
+		  continue;
+	    }
+
+	    lookup_[idx] = test_levels(cur);
+      }
+}
+
 static void or_based_on_char(udp_levels_table&cur, char flag,
 			     unsigned long mask_bit)
 {
@@ -290,6 +334,8 @@ void vvp_udp_comb_s::compile_table(char**tab)
 
       assert(nrows0 == nlevels0_);
       assert(nrows1 == nlevels1_);
+
+      compile_lookup_();
 }
 
 vvp_udp_seq_s::vvp_udp_seq_s(char*label, char*name__,
@@ -313,6 +359,8 @@ vvp_udp_seq_s::vvp_udp_seq_s(char*label, char*name__,
       nedges0_ = 0;
       nedges1_ = 0;
       nedgesL_ = 0;
+
+      lookup_ = 0;
 }
 
 vvp_udp_seq_s::~vvp_udp_seq_s()
@@ -324,6 +372,7 @@ vvp_udp_seq_s::~vvp_udp_seq_s()
       delete[] edges0_;
       delete[] edges1_;
       delete[] edgesL_;
+      delete[] lookup_;
 }
 
 void edge_based_on_char(struct udp_edges_table&cur, char chr, unsigned pos)
@@ -670,6 +719,7 @@ void vvp_udp_seq_s::compile_table(char**tab)
       assert(idx_edg1 == nedges1_);
       assert(idx_edgL == nedgesL_);
 
+      compile_lookup_();
 }
 
 bool operator == (const udp_levels_table&a, const udp_levels_table&b)
@@ -690,6 +740,33 @@ vvp_bit4_t vvp_udp_seq_s::calculate_output(const udp_levels_table&cur,
       if (cur == prev)
 	    return cur_out;
 
+      const unsigned nports = port_count();
+
+	/* If there is a lookup table and a single input changed (the
+	   normal case) then the table has the answer. */
+      unsigned long edge_mask = (cur.mask0 ^ prev.mask0)
+	                      | (cur.maskx ^ prev.maskx)
+	                      | (cur.mask1 ^ prev.mask1);
+      if (lookup_ && (edge_mask & (edge_mask-1)) == 0) {
+	    unsigned edge_position = 0;
+	    while ((edge_mask >> edge_position) != 1)
+		  edge_position += 1;
+
+	    unsigned edge_from = (prev.mask1 & edge_mask)? 1
+		               : (prev.maskx & edge_mask)? 2 : 0;
+
+	    unsigned long state1 = cur.mask1;
+	    unsigned long statex = cur.maskx;
+	    if (cur_out == BIT4_1)
+		  state1 |= 1UL << nports;
+	    else if (cur_out != BIT4_0)
+		  statex |= 1UL << nports;
+
+	    unsigned long idx = (edge_position*3 + edge_from) << (2*(nports+1));
+	    idx |= state1 | (statex << (nports+1));
+	    return (vvp_bit4_t) lookup_[idx];
+      }
+
       udp_levels_table cur_tmp = cur;
 
       unsigned long mask_out = 1UL << port_count();
@@ -713,6 +790,67 @@ vvp_bit4_t vvp_udp_seq_s::calculate_output(const udp_levels_table&cur,
       return lev;
 }
 
+void vvp_udp_seq_s::compile_lookup_()
+{
+      const unsigned nports = port_count();
+      if (nports > UDP_SEQ_LOOKUP_PORTS)
+	    return;
+
+	/* The state includes the current output as bit [nports]. */
+      const unsigned long state_mask = (1UL << (nports+1)) - 1;
+      const unsigned long input_mask = (1UL << nports) - 1;
+      const unsigned long nstates = 1UL << (2*(nports+1));
+      lookup_ = new unsigned char[3*nports*nstates];
+
+      for (unsigned pos = 0 ;  pos < nports ;  pos += 1) {
+	    unsigned long edge_mask = 1UL << pos;
+
+	    for (unsigned from = 0 ;  from < 3 ;  from += 1) {
+		  unsigned char*tab = lookup_ + (pos*3 + from)*nstates;
+
+		  for (unsigned long idx = 0 ;  idx < nstates ;  idx += 1) {
+			udp_levels_table cur;
+			cur.mask1 = idx & state_mask;
+			cur.maskx = idx >> (nports+1);
+			cur.mask0 = state_mask & ~(cur.mask1 | cur.maskx);
+
+			  // Build the previous inputs by moving the
+			  // changed input back to its old value.
+			udp_levels_table prev;
+			prev.mask0 = cur.mask0 & input_mask & ~edge_mask;
+			prev.mask1 = cur.mask1 & input_mask & ~edge_mask;
+			prev.maskx = cur.maskx & input_mask & ~edge_mask;
+			switch (from) {
+			    case 0:
+			      prev.mask0 |= edge_mask;
+			      break;
+			    case 1:
+			      prev.mask1 |= edge_mask;
+			      break;
+			    default:
+			      prev.maskx |= edge_mask;
+			      break;
+			}
+
+			  // Skip impossible states, and the entries where
+			  // the input did not actually change.
+			unsigned long diff = (prev.mask0 ^ cur.mask0)
+			                   | (prev.mask1 ^ cur.mask1)
+			                   | (prev.maskx ^ cur.maskx);
+			if ((cur.mask1 & cur.maskx) || (diff & edge_mask) == 0) {
+			      tab[idx] = BIT4_X;
+			      continue;
+			}
+
+			vvp_bit4_t lev = test_levels_(cur);
+			if (lev == BIT4_Z)
+			      lev = test_edges_(cur, prev);
+			tab[idx] = lev;
+		  }
+	    }
+      }
+}
+
 /*
  * This function tests the levels of the input with the additional
  * check match for the current output. It uses this to calculate a
@@ -989,4 +1127,7 @@ void compile_udp_functor(char*label, char*type,
 
       wide_inputs_connect(core, argc, argv);
       free(argv);
+
+      if (schedule_levelize_flag)
+	    schedule_levelize_net(ptr);
 }
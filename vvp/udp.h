@@ -131,6 +131,11 @@ class vvp_udp_comb_s : public vvp_udp_s {
       struct udp_levels_table*levels0_;
       struct udp_levels_table*levels1_;
       unsigned nlevels0_, nlevels1_;
+
+	// For devices with few enough inputs, the rows are expanded
+	// into a truth table indexed by mask1|(maskx<<port_count()).
+      void compile_lookup_();
+      unsigned char*lookup_;
 };
 
 /*
@@ -208,6 +213,11 @@ class vvp_udp_seq_s : public vvp_udp_s {
       struct udp_edges_table*edgesL_;
       unsigned nedges0_, nedges1_, nedgesL_;
 
+	// For devices with few enough inputs, the level and edge rows
+	// are expanded into a table that gives the next output for
+	// every current input/output state and single input edge.
+      void compile_lookup_();
+      unsigned char*lookup_;
 };
 
 /*
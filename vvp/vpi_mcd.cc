@@ -27,6 +27,7 @@
 # include  <cstdio>
 # include  <cstdlib>
 # include  <cstring>
+# include  <unistd.h>
 # include  "ivl_alloc.h"
 
 extern FILE* vpi_trace;
@@ -55,6 +56,29 @@ static unsigned fd_table_len = 0;
 
 static FILE* logfile;
 
+/*
+ * If vpip_file_buffer_size is set (VVP_FILE_BUFFER_SIZE), files that
+ * the simulation opens for writing get a stdio buffer of that size, so
+ * a testbench that logs with $fwrite or $fdisplay makes a few large
+ * writes to the disk instead of many small ones. This is off by
+ * default because a larger buffer holds more output back from a log
+ * that is being watched, and more is lost if vvp crashes. Terminals
+ * keep their default buffering so output appears as usual.
+ */
+size_t vpip_file_buffer_size = 0;
+
+static void set_file_buffer(FILE*fp, const char*mode)
+{
+      if (vpip_file_buffer_size == 0)
+	    return;
+      if (strchr(mode, 'w') == 0 && strchr(mode, 'a') == 0)
+	    return;
+      if (isatty(fileno(fp)))
+	    return;
+
+      setvbuf(fp, 0, _IOFBF, vpip_file_buffer_size);
+}
+
 /* Initialize mcd portion of vpi.  Must be called before
  * any vpi_mcd routines can be used.
  */
@@ -174,6 +198,7 @@ got_entry:
 #endif
 	if(mcd_table[i].fp == NULL)
 		return 0;
+	set_file_buffer(mcd_table[i].fp, "w");
 	mcd_table[i].filename = strdup(name);
 
 	if (vpi_trace) {
@@ -317,6 +342,7 @@ got_entry:
 		fd_table[i].fp = fopen("nul", mode);
 #endif
       if (fd_table[i].fp == NULL) return 0;
+      set_file_buffer(fd_table[i].fp, mode);
       fd_table[i].filename = strdup(name);
       return ((1U<<31)|i);
 }
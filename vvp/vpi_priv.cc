@@ -1746,5 +1746,7 @@ vpip_routines_s vpi_routines = {
     .make_systf_system_defined  = vpip_make_systf_system_defined,
     .mcd_rawwrite               = vpip_mcd_rawwrite,
     .set_return_value           = vpip_set_return_value,
+    .get_array_words            = vpip_get_array_words,
+    .put_array_words            = vpip_put_array_words,
 };
 #endif
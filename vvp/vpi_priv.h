@@ -272,12 +272,18 @@ class __vpiScope : public __vpiHandle {
         /* Keep an array of items to be automatically allocated */
       struct automatic_hooks_s**item;
       unsigned nitem;
+        /* The size of a context block, including the items that are
+           stored in the block. This is zero until it is computed. */
+      size_t context_size;
         /* Keep a list of live contexts. */
       vvp_context_t live_contexts;
         /* Keep a list of freed contexts. */
       vvp_context_t free_contexts;
-	/* Keep a list of threads in the scope. */
-      std::set<vthread_t> threads;
+	/* Keep a list of reaped threads that can be reused. */
+      vthread_t free_threads;
+	/* Keep a list of threads in the scope. The list is linked
+	   through the scope_* members of the threads. */
+      vthread_t threads;
       signed int time_units :8;
       signed int time_precision :8;
 
@@ -697,6 +703,11 @@ struct __vpiArray : public __vpiArrayBase, public __vpiHandle {
       void get_word_obj(unsigned address, vvp_object_t&val);
       std::string get_word_str(unsigned address);
 
+	// Bulk access to a range of vector words in the vpiVectorVal
+	// format. These implement vpip_get/put_array_words().
+      void get_words(unsigned address, unsigned count, s_vpi_vecval*buf);
+      void put_words(unsigned address, unsigned count, const s_vpi_vecval*buf);
+
       void alias_word(unsigned long addr, vpiHandle word, int msb, int lsb);
       void attach_word(unsigned addr, vpiHandle word);
       void word_change(unsigned long addr);
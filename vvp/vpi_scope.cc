@@ -329,7 +329,7 @@ static vpiHandle module_iter(int code, vpiHandle obj)
 
 
 __vpiScope::__vpiScope(const char*nam, const char*tnam, bool auto_flag)
-: is_automatic_(auto_flag)
+: free_threads(0), threads(0), is_automatic_(auto_flag)
 {
       name_ = vpip_name_string(nam);
       tname_ = vpip_name_string(tnam? tnam : "");
@@ -546,6 +546,7 @@ compile_scope_decl(char*label, char*type, char*name, char*tname,
       scope->def_lineno  = (unsigned) def_lineno;
       scope->item = 0;
       scope->nitem = 0;
+      scope->context_size = 0;
       scope->live_contexts = 0;
       scope->free_contexts = 0;
 
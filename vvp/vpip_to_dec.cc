@@ -25,201 +25,186 @@
 #endif
 # include  <cstdio>
 # include  <cstring>
-# include  <climits>     /* for CHAR_BIT */
 # include  <cstdlib>
 # include  <cctype>
 # include  <cassert>
 # include  "ivl_alloc.h"
 
-/* If you are allergic to malloc, you can set a stack memory allocation
- * here.  Otherwise, malloc() is used for the temporary array, so the
- * conversion length is unlimited. */
-/* #define MAX_DIGITS 20 */
-
-
-#if SIZEOF_UNSIGNED_LONG * CHAR_BIT >= 64
-#define BDIGITS 9
-#define BASE 1000000000
-#define BBITS 32
-#define BMASK 0xffffffff
-#else
-#if SIZEOF_UNSIGNED_LONG * CHAR_BIT >= 32
-#define BDIGITS 4
-#define BASE 10000
-#define BBITS 16
-#define BMASK 0xffff
-#else
-#error apparent non-conforming word length
-#endif
-#endif
-
-#define B_IS0(x)  ((x) == 0)
-#define B_IS1(x)  ((x) == 1)
-#define B_ISX(x)  ((x) == 2)
-#define B_ISZ(x)  ((x) == 3)
-
-/* The program works by building a base BASE representation of the number
- * in the valv array.  BBITS bits of the number can be put in at a time.
- * Previous values of each valv element are always less than BASE, the
- * input val is less than or equal to 2^BBITS, so (valv[i]<<BBITS)+val
- * is guaranteed less than or equal to BASE<<BBITS, which is configured
- * less than ULONG_MAX.  When this number divided by BASE, to get the amount
- * propagated as a "carry" to the next array element, the result is again
- * less than or equal to 2^BBITS.  BBITS and BASE are configured above
- * to depend on the "unsigned long" length of the host, for efficiency.
+/*
+ * The conversions work on the magnitude of the value as an array of
+ * 32 bit limbs, least significant first. Values up to this many limbs
+ * use scratch space on the stack, larger ones allocate it. There is
+ * no shared state, so the conversions are reentrant.
  */
-static inline void shift_in(unsigned long *valv, unsigned int vlen, unsigned long val)
+static const unsigned DEC_STACK_LIMBS = 64;
+static const uint32_t DEC_CHUNK = 1000000000;
+static const unsigned DEC_CHUNK_DIGITS = 9;
+
+static const unsigned LIMBS_PER_WORD = sizeof(unsigned long) / sizeof(uint32_t);
+static const unsigned BITS_PER_ULONG = 8 * sizeof(unsigned long);
+
+static char* write_u64(uint64_t val, char*buf)
 {
-	unsigned int i;
-	/* printf("shift in %u\n",val); */
-	for (i=0; i<vlen; i++) {
-		val=(valv[i]<<BBITS)+val;
-		valv[i]=val%BASE;
-		val=val/BASE;
-	}
-	if (val!=0)
-	      fprintf(stderr,"internal error: carry out %lu in " __FILE__ "\n",val);
+      char tmp[20];
+      unsigned cnt = 0;
+      do {
+	    tmp[cnt++] = '0' + val%10;
+	    val /= 10;
+      } while (val);
+
+      while (cnt > 0)
+	    *buf++ = tmp[--cnt];
+      return buf;
 }
 
-/* Since BASE is a power of ten, conversion of each element of the
- * valv array to decimal is easy.  sprintf(buf,"%d",v) could be made
- * to work, I suppose, but for speed and control I prefer to write
- * the steps out longhand.
+/*
+ * Write the magnitude in the limbs as decimal digits with no leading
+ * zeros. Values that fit in 64 bits are written directly. Wider values
+ * are divided by 10^9 over and over, and each remainder gives the next
+ * nine digits, so each pass over the limbs produces nine digits instead
+ * of shifting in one bit at a time. The limbs are destroyed.
  */
-static inline int write_digits(unsigned long v, char **buf,
-                               unsigned int *nbuf, int zero_suppress)
+static char* write_limbs(uint32_t*limbs, unsigned nlimbs, char*buf)
 {
-	char segment[BDIGITS];
-	int i;
-	for (i=BDIGITS-1; i>=0; --i) {
-		segment[i] = '0' + v%10;
-		v=v/10;
-	}
-	for (i=0; i<BDIGITS; ++i) {
-		if (!(zero_suppress&=(segment[i]=='0'))) {
-			*(*buf)++=segment[i]; --(*nbuf);
-		}
-	}
-	return zero_suppress;
-}
+      while (nlimbs > 0 && limbs[nlimbs-1] == 0)
+	    nlimbs -= 1;
+
+      if (nlimbs <= 2) {
+	    uint64_t val = 0;
+	    if (nlimbs > 1) val = (uint64_t)limbs[1] << 32;
+	    if (nlimbs > 0) val |= limbs[0];
+	    return write_u64(val, buf);
+      }
 
-/* Jump through some hoops so we don't have to malloc/free valv
- * on every call, and implement an optional malloc-less version. */
-static unsigned long *valv=NULL;
-static unsigned int vlen_alloc=0;
+	/* Each limb holds less than two chunks worth of digits. */
+      uint32_t chunk_stack[2*DEC_STACK_LIMBS];
+      uint32_t*chunks = nlimbs <= DEC_STACK_LIMBS
+	    ? chunk_stack : new uint32_t[2*nlimbs];
+      unsigned nchunks = 0;
 
-#ifdef CHECK_WITH_VALGRIND
-void dec_str_delete(void)
+      while (nlimbs > 0) {
+	    uint64_t rem = 0;
+	    for (unsigned idx = nlimbs ; idx > 0 ; idx -= 1) {
+		  uint64_t cur = (rem << 32) | limbs[idx-1];
+		  limbs[idx-1] = (uint32_t)(cur / DEC_CHUNK);
+		  rem = cur % DEC_CHUNK;
+	    }
+	    chunks[nchunks++] = (uint32_t)rem;
+	    while (nlimbs > 0 && limbs[nlimbs-1] == 0)
+		  nlimbs -= 1;
+      }
+
+	/* Only the most significant chunk is zero suppressed. */
+      buf = write_u64(chunks[nchunks-1], buf);
+      for (unsigned idx = nchunks-1 ; idx > 0 ; idx -= 1) {
+	    uint32_t val = chunks[idx-1];
+	    for (unsigned dig = DEC_CHUNK_DIGITS ; dig > 0 ; dig -= 1) {
+		  buf[dig-1] = '0' + val%10;
+		  val /= 10;
+	    }
+	    buf += DEC_CHUNK_DIGITS;
+      }
+
+      if (chunks != chunk_stack)
+	    delete[]chunks;
+      return buf;
+}
+
+/*
+ * Replace the mbits wide value in the limbs with its two's complement
+ * negation, which may carry into bit mbits.
+ */
+static void negate_limbs(uint32_t*limbs, unsigned nlimbs, unsigned mbits)
 {
-      free(valv);
-      valv = 0;
-      vlen_alloc = 0;
+      for (unsigned idx = 0 ; idx < nlimbs ; idx += 1) {
+	    unsigned base = 32*idx;
+	    if (base + 32 <= mbits)
+		  limbs[idx] = ~limbs[idx];
+	    else if (base < mbits)
+		  limbs[idx] = ~limbs[idx] & ((1U << (mbits-base)) - 1);
+	    else
+		  limbs[idx] = 0;
+      }
+
+      for (unsigned idx = 0 ; idx < nlimbs ; idx += 1) {
+	    limbs[idx] += 1;
+	    if (limbs[idx] != 0)
+		  break;
+      }
 }
-#endif
 
 unsigned vpip_vec4_to_dec_str(const vvp_vector4_t&vec4,
-			      char *buf, unsigned int nbuf,
+			      char *buf, unsigned int,
 			      int signed_flag)
 {
-      unsigned int idx, vlen;
-      unsigned int mbits=vec4.size();   /* number of non-sign bits */
-      unsigned count_x = 0, count_z = 0;
-
-      unsigned long val=0;
-      int comp=0;
-      if (signed_flag) {
-	    switch (vec4.value(vec4.size()-1)) {
-		case BIT4_X:
-		  count_x += 1;
-		  break;
-		case BIT4_Z:
-		  count_z += 1;
-		  break;
-		case BIT4_1:
-		  comp=1;
-		  break;
-		case BIT4_0:
-		  break;
+      unsigned wid = vec4.size();
+
+      if (vec4.has_xz()) {
+	    unsigned count_x = 0, count_z = 0;
+	    for (unsigned idx = 0 ; idx < wid ; idx += 1) {
+		  switch (vec4.value(idx)) {
+		      case BIT4_X:
+			count_x += 1;
+			break;
+		      case BIT4_Z:
+			count_z += 1;
+			break;
+		      default:
+			break;
+		  }
 	    }
-	    mbits -= 1;
+
+	    if (count_x == wid)
+		  buf[0] = 'x';
+	    else if (count_x > 0)
+		  buf[0] = 'X';
+	    else if (count_z == wid)
+		  buf[0] = 'z';
+	    else
+		  buf[0] = 'Z';
+	    buf[1] = 0;
+	    return 0;
       }
-      assert(mbits<(UINT_MAX-92)/28);
-      vlen = ((mbits*28+92)/93+BDIGITS-1)/BDIGITS;
-	/* printf("vlen=%d\n",vlen); */
-
-#define ALLOC_MARGIN 4
-      if (!valv || vlen > vlen_alloc) {
-	    if (valv) free(valv);
-	    valv = (unsigned long*) calloc(vlen+ALLOC_MARGIN, sizeof (*valv));
-	    vlen_alloc=vlen+ALLOC_MARGIN;
-      } else {
-	    memset(valv,0,vlen*sizeof(valv[0]));
+
+	/* A negative signed value is written as '-' and the magnitude
+	   of the non-sign bits. 1'sb1 is therefore written as "-1". */
+      bool comp = false;
+      unsigned mbits = wid;
+      if (signed_flag && wid > 0) {
+	    comp = vec4.value(wid-1) == BIT4_1;
+	    mbits -= 1;
       }
 
-      for (idx = 0; idx < mbits; idx += 1) {
-	      /* printf("%c ",bits[mbits-idx-1]); */
-	    switch (vec4.value(mbits-idx-1)) {
-		case BIT4_Z:
-		  count_z += 1;
-		  break;
-		case BIT4_X:
-		  count_x += 1;
-		  break;
-		case BIT4_1:
-		  if (! comp)
-			val += 1;
-		  break;
-		case BIT4_0:
-		  if (comp)
-			val += 1;
-		  break;
-	    }
+	/* Leave an extra limb for the carry out of the negation. */
+      unsigned nwords = (mbits + BITS_PER_ULONG - 1) / BITS_PER_ULONG;
+      unsigned nlimbs = nwords * LIMBS_PER_WORD + 1;
+      uint32_t limb_stack[DEC_STACK_LIMBS];
+      uint32_t*limbs = nlimbs <= DEC_STACK_LIMBS
+	    ? limb_stack : new uint32_t[nlimbs];
 
-	    if ((mbits-idx-1)%BBITS==0) {
-		    /* make negative 2's complement, not 1's complement */
-		  if (comp && idx==mbits-1) ++val;
-		  shift_in(valv,vlen,val);
-		  val=0;
-	    } else {
-		  val=val+val;
+      unsigned long*words = vec4.subarray(0, mbits);
+      for (unsigned idx = 0 ; idx < nwords ; idx += 1) {
+	    unsigned long word = words[idx];
+	    for (unsigned part = 0 ; part < LIMBS_PER_WORD ; part += 1) {
+		  limbs[idx*LIMBS_PER_WORD + part] = (uint32_t)word;
+		  word >>= 16;
+		  word >>= 16;
 	    }
       }
+      limbs[nlimbs-1] = 0;
+      delete[]words;
 
-	if (count_x == vec4.size()) {
-	      buf[0] = 'x';
-	      buf[1] = 0;
-	} else if (count_x > 0) {
-	      buf[0] = 'X';
-	      buf[1] = 0;
-	} else if (count_z == vec4.size()) {
-	      buf[0] = 'z';
-	      buf[1] = 0;
-	} else if (count_z > 0) {
-	      buf[0] = 'Z';
-	      buf[1] = 0;
-	} else {
-	      int i;
-	      int zero_suppress=1;
-	      if (comp) {
-		    *buf++='-';
-		    nbuf--;
-		      /* printf("-"); */
-	      }
-	      for (i=vlen-1; i>=0; i--) {
-		    zero_suppress = write_digits(valv[i],
-						 &buf,&nbuf,zero_suppress);
-		      /* printf(",%.4u",valv[i]); */
-	      }
-		/* Awkward special case, since we don't want to
-		 * zero suppress down to nothing at all.  The only
-		 * way we can still have zero_suppress on in the
-		 * comp=1 case is if mbits==0, and therefore vlen==0.
-		 * We represent 1'sb1 as "-1". */
-	      if (zero_suppress) *buf++='0'+comp;
-		/* printf("\n"); */
-	      *buf='\0';
-	}
-	return 0;
+      if (comp) {
+	    negate_limbs(limbs, nlimbs, mbits);
+	    *buf++ = '-';
+      }
+
+      buf = write_limbs(limbs, nlimbs, buf);
+      *buf = 0;
+
+      if (limbs != limb_stack)
+	    delete[]limbs;
+      return 0;
 }
 
 void vpip_dec_str_to_vec4(vvp_vector4_t&vec, const char*buf)
@@ -288,40 +273,60 @@ void vpip_dec_str_to_vec4(vvp_vector4_t&vec, const char*buf)
 		  for (unsigned jdx = 0 ;  jdx < vec.size() ;  jdx += 1) {
 			vec.set_bit(jdx, BIT4_X);
 		  }
+		  delete[]str;
 		  return;
             }
       }
 
       str[slen] = 0;
 
-      for (unsigned idx = 0 ;  idx < vec.size() ;  idx += 1) {
-	    vvp_bit4_t val4 = BIT4_0;
+	/* Build the value in 32 bit limbs, nine digits at a time, most
+	   significant digits first. Limbs past the width of the vector
+	   are not needed, since the carries only move up. */
+      unsigned nwords = (vec.size() + BITS_PER_ULONG - 1) / BITS_PER_ULONG;
+      unsigned nlimbs = nwords * LIMBS_PER_WORD;
+      uint32_t limb_stack[DEC_STACK_LIMBS];
+      uint32_t*limbs = nlimbs <= DEC_STACK_LIMBS
+	    ? limb_stack : new uint32_t[nlimbs];
+      for (unsigned idx = 0 ; idx < nlimbs ; idx += 1)
+	    limbs[idx] = 0;
 
-	    switch (str[0]) {
-		case '1':
-		case '3':
-		case '5':
-		case '7':
-		case '9':
-		  val4 = BIT4_1;
-		  break;
+      unsigned pos = slen;
+      while (pos > 0) {
+	    unsigned cnt = (pos-1) % DEC_CHUNK_DIGITS + 1;
+	    uint32_t mul = 1, add = 0;
+	    for (unsigned dig = 0 ; dig < cnt ; dig += 1) {
+		  pos -= 1;
+		  mul *= 10;
+		  add = add*10 + (str[pos] - '0');
 	    }
 
-	    vec.set_bit(idx, val4);
-
-	      /* Divide the str string by 2 in decimal. */
-	    char*cp = str;
-	    while (*cp) {
-		  unsigned val = cp[0] - '0';
-		  if ((val&1) && (cp > str))
-			cp[-1] += 5;
-
-		  cp[0] = '0' + val/2;
-		  cp += 1;
+	    uint64_t carry = add;
+	    for (unsigned idx = 0 ; idx < nlimbs ; idx += 1) {
+		  uint64_t cur = (uint64_t)limbs[idx] * mul + carry;
+		  limbs[idx] = (uint32_t)cur;
+		  carry = cur >> 32;
 	    }
+      }
 
+      if (nwords > 0) {
+	    unsigned long*words = new unsigned long[nwords];
+	    for (unsigned idx = 0 ; idx < nwords ; idx += 1) {
+		  unsigned long word = 0;
+		  for (unsigned part = LIMBS_PER_WORD ; part > 0 ; part -= 1) {
+			word <<= 16;
+			word <<= 16;
+			word |= limbs[idx*LIMBS_PER_WORD + part-1];
+		  }
+		  words[idx] = word;
+	    }
+	    vec.setarray(0, vec.size(), words);
+	    delete[]words;
       }
 
+      if (limbs != limb_stack)
+	    delete[]limbs;
+
       if (is_negative) {
             vec.invert();
             vec += (int64_t) 1;
@@ -28,6 +28,8 @@
 # include  "vvp_cobject.h"
 # include  "vvp_darray.h"
 # include  "class_type.h"
+# include  "profile.h"
+# include  "slab.h"
 #ifdef CHECK_WITH_VALGRIND
 # include  "vvp_cleanup.h"
 #endif
@@ -59,25 +61,26 @@ using namespace std;
  * ** Notes On The Interactions of %fork/%join/%end:
  *
  * The %fork instruction creates a new thread and pushes that into a
- * set of children for the thread. This new thread, then, becomes a
+ * list of children for the thread. This new thread, then, becomes a
  * child of the current thread, and the current thread a parent of the
  * new thread. Any child can be reaped by a %join.
  *
  * Children that are detached with %join/detach need to have a different
  * parent/child relationship since the parent can still effect them if
  * it uses the %disable/fork or %wait/fork opcodes. The i_am_detached
- * flag and detached_children set are used for this relationship.
+ * flag and detached_children list are used for this relationship.
  *
  * Children placed into a task or function scope are given special
  * treatment, which is required to make task/function calls that they
- * represent work correctly. These task/function children are copied
- * into a task_func_children set to mark them for this handling. %join
+ * represent work correctly. These task/function children are marked
+ * with the i_am_task_func flag for this handling, and the parent
+ * keeps a count of them in task_func_children. %join
  * operations will guarantee that task/function threads are joined first,
  * before any non-task/function threads.
  *
  * It is a programming error for a thread that created threads to not
  * %join (or %join/detach) as many as it created before it %ends. The
- * children set will get messed up otherwise.
+ * children list will get messed up otherwise.
  *
  * the i_am_joining flag is a clue to children that the parent is
  * blocked in a %join and may need to be scheduled. The %end
@@ -94,16 +97,66 @@ using namespace std;
  * to reap the child immediately.
  */
 
+
+/*
+ * The children and detached children of a thread are kept in
+ * intrusive lists, linked through the sib_* members of the child
+ * threads, so that %fork and %join do not allocate. A thread is in at
+ * most one such list at a time.
+ */
+struct vthread_list_s {
+      vthread_list_s() : head_(0), count_(0) { }
+
+      bool empty() const { return head_ == 0; }
+      size_t size() const { return count_; }
+      vthread_t front() const { return head_; }
+
+      inline void insert(vthread_t thr);
+	// Remove the thread from the list. Return the number of
+	// threads removed (0 or 1), like std::set::erase.
+      inline size_t erase(vthread_t thr);
+	// Unlink all the threads from the list.
+      inline void clear();
+
+    private:
+      vthread_t head_;
+      size_t count_;
+};
+
 struct vthread_s {
       vthread_s();
 
+      static void* operator new(size_t);
+      static void operator delete(void*);
+
       void debug_dump(ostream&fd, const char*label_text);
 
 	/* This is the program counter. */
       vvp_code_t pc;
 	/* These hold the private thread bits. */
       enum { FLAGS_COUNT = 512, WORDS_COUNT = 16 };
-      vvp_bit4_t flags[FLAGS_COUNT];
+
+	/* The flags are stored a byte each instead of as (int sized)
+	   vvp_bit4_t values to keep the thread small. The flag_ref
+	   proxy lets them be used like an array of vvp_bit4_t. */
+      class flag_ref {
+	  public:
+	    explicit flag_ref(unsigned char&bit) : bit_(bit) { }
+	    operator vvp_bit4_t() const { return (vvp_bit4_t)bit_; }
+	    flag_ref& operator= (vvp_bit4_t val)
+	    { bit_ = val; return *this; }
+	    flag_ref& operator= (const flag_ref&that)
+	    { bit_ = that.bit_; return *this; }
+	  private:
+	    unsigned char&bit_;
+      };
+      struct flags_t {
+	    vvp_bit4_t operator[] (unsigned idx) const
+	    { return (vvp_bit4_t)bits[idx]; }
+	    flag_ref operator[] (unsigned idx)
+	    { return flag_ref(bits[idx]); }
+	    unsigned char bits[FLAGS_COUNT];
+      } flags;
 
 	/* These are the word registers. */
       union {
@@ -279,16 +332,27 @@ struct vthread_s {
       unsigned waiting_for_event :1;
       unsigned is_scheduled      :1;
       unsigned delay_delete      :1;
+      unsigned i_am_task_func    :1; // Counted in task_func_children
 	/* This points to the children of the thread. */
-      set<struct vthread_s*>children;
+      vthread_list_s children;
 	/* This points to the detached children of the thread. */
-      set<struct vthread_s*>detached_children;
+      vthread_list_s detached_children;
 	/* No more than 1 of the children are tasks or functions. */
-      set<vthread_s*>task_func_children;
+      unsigned task_func_children;
+	/* These link me into the children or detached_children list
+	   of my parent. */
+      vthread_list_s*sib_list;
+      struct vthread_s*sib_prev, *sib_next;
 	/* This points to my parent, if I have one. */
       struct vthread_s*parent;
 	/* This points to the containing scope. */
       __vpiScope*parent_scope;
+	/* These link me into the threads list of the containing
+	   scope. in_scope is set while I am in that list. */
+      unsigned in_scope :1;
+      struct vthread_s*scope_prev, *scope_next;
+	/* This is the last %file_line executed, for the profiler. */
+      vpiHandle prof_line;
 	/* This is used for keeping wait queues. */
       struct vthread_s*wait_next;
 	/* These are used to access automatically allocated items. */
@@ -317,6 +381,92 @@ inline vthread_s::vthread_s()
       stack_obj_size_ = 0;
 }
 
+/*
+ * Threads are created and reaped at a high rate by fork-heavy code,
+ * so they are allocated from a slab pool.
+ */
+static const size_t VTHREAD_CHUNK_COUNT = 65536 / sizeof(struct vthread_s) + 1;
+static slab_t<sizeof(vthread_s),VTHREAD_CHUNK_COUNT> vthread_heap;
+
+inline void* vthread_s::operator new(size_t size)
+{
+      assert(size == sizeof(vthread_s));
+      return vthread_heap.alloc_slab();
+}
+
+void vthread_s::operator delete(void*ptr)
+{
+      vthread_heap.free_slab(ptr);
+}
+
+inline void vthread_list_s::insert(vthread_t thr)
+{
+      assert(thr->sib_list == 0);
+      thr->sib_list = this;
+      thr->sib_prev = 0;
+      thr->sib_next = head_;
+      if (head_) head_->sib_prev = thr;
+      head_ = thr;
+      count_ += 1;
+}
+
+inline size_t vthread_list_s::erase(vthread_t thr)
+{
+      if (thr->sib_list != this)
+	    return 0;
+
+      if (thr->sib_prev)
+	    thr->sib_prev->sib_next = thr->sib_next;
+      else
+	    head_ = thr->sib_next;
+      if (thr->sib_next)
+	    thr->sib_next->sib_prev = thr->sib_prev;
+
+      thr->sib_list = 0;
+      thr->sib_prev = 0;
+      thr->sib_next = 0;
+      count_ -= 1;
+      return 1;
+}
+
+inline void vthread_list_s::clear()
+{
+      while (head_)
+	    erase(head_);
+}
+
+/*
+ * The threads of a scope are kept in an intrusive list in the same
+ * way, linked through the scope_* members, so that creating and
+ * reaping a thread does not allocate. %disable walks this list.
+ */
+static inline void scope_thread_insert(__vpiScope*scope, vthread_t thr)
+{
+      assert(! thr->in_scope);
+      thr->in_scope = 1;
+      thr->scope_prev = 0;
+      thr->scope_next = scope->threads;
+      if (scope->threads) scope->threads->scope_prev = thr;
+      scope->threads = thr;
+}
+
+static inline void scope_thread_erase(__vpiScope*scope, vthread_t thr)
+{
+      if (! thr->in_scope)
+	    return;
+
+      if (thr->scope_prev)
+	    thr->scope_prev->scope_next = thr->scope_next;
+      else
+	    scope->threads = thr->scope_next;
+      if (thr->scope_next)
+	    thr->scope_next->scope_prev = thr->scope_prev;
+
+      thr->in_scope = 0;
+      thr->scope_prev = 0;
+      thr->scope_next = 0;
+}
+
 void vthread_s::debug_dump(ostream&fd, const char*label)
 {
       fd << "**** " << label << endl;
@@ -457,6 +607,50 @@ static void multiply_array_imm(unsigned long*res, unsigned long*val,
       }
 }
 
+/*
+ * The items of a context that support it are stored in the context
+ * block itself, after the list links and item pointers, so that a new
+ * context is a single allocation. Each item is aligned to a double.
+ */
+static inline size_t context_align(size_t size)
+{
+      const size_t align = sizeof(double) > sizeof(void*)
+	    ? sizeof(double) : sizeof(void*);
+      return (size + align - 1) & ~(align - 1);
+}
+
+static size_t vthread_context_size(__vpiScope*scope)
+{
+      if (scope->context_size == 0) {
+	    size_t size = context_align((2 + scope->nitem) * sizeof(void*));
+	    for (unsigned idx = 0 ; idx < scope->nitem ; idx += 1)
+		  size += context_align(scope->item[idx]->instance_size());
+	    scope->context_size = size;
+      }
+      return scope->context_size;
+}
+
+static vvp_context_t vthread_new_context(__vpiScope*scope)
+{
+      size_t size = vthread_context_size(scope);
+      vvp_context_t context = (vvp_context_t)malloc(size);
+      char*data = (char*)context
+	    + context_align((2 + scope->nitem) * sizeof(void*));
+
+      for (unsigned idx = 0 ; idx < scope->nitem ; idx += 1) {
+	    automatic_hooks_s*item = scope->item[idx];
+	    size_t item_size = item->instance_size();
+	    if (item_size > 0) {
+		  vvp_set_context_item(context, 2 + idx, data);
+		  data += context_align(item_size);
+	    }
+	    item->alloc_instance(context);
+      }
+      assert(data <= (char*)context + size);
+
+      return context;
+}
+
 /*
  * Allocate a context for use by a child thread. By preference, use
  * the last freed context. If none available, create a new one. Add
@@ -473,10 +667,7 @@ static vvp_context_t vthread_alloc_context(__vpiScope*scope)
                   scope->item[idx]->reset_instance(context);
             }
       } else {
-            context = vvp_allocate_context(scope->nitem);
-            for (unsigned idx = 0 ; idx < scope->nitem ; idx += 1) {
-                  scope->item[idx]->alloc_instance(context);
-            }
+            context = vthread_new_context(scope);
       }
 
       vvp_set_next_context(context, scope->live_contexts);
@@ -532,11 +723,17 @@ void contexts_delete(struct __vpiScope*scope)
  */
 vthread_t vthread_new(vvp_code_t pc, __vpiScope*scope)
 {
-      vthread_t thr = new struct vthread_s;
+      vthread_t thr = scope->free_threads;
+      if (thr)
+	    scope->free_threads = thr->wait_next;
+      else
+	    thr = new struct vthread_s;
+
       thr->pc     = pc;
 	//thr->bits4  = vvp_vector4_t(32);
       thr->parent = 0;
       thr->parent_scope = scope;
+      thr->prof_line = 0;
       thr->wait_next = 0;
       thr->wt_context = 0;
       thr->rd_context = 0;
@@ -549,6 +746,14 @@ vthread_t vthread_new(vvp_code_t pc, __vpiScope*scope)
       thr->i_have_ended  = 0;
       thr->i_was_disabled = 0;
       thr->delay_delete  = 0;
+      thr->i_am_task_func = 0;
+      thr->task_func_children = 0;
+      thr->sib_list = 0;
+      thr->sib_prev = 0;
+      thr->sib_next = 0;
+      thr->in_scope = 0;
+      thr->scope_prev = 0;
+      thr->scope_next = 0;
       thr->waiting_for_event = 0;
       thr->event  = 0;
       thr->ecount = 0;
@@ -560,7 +765,7 @@ vthread_t vthread_new(vvp_code_t pc, __vpiScope*scope)
       for (int idx = 4 ; idx < 8 ; idx += 1)
 	    thr->flags[idx] = BIT4_X;
 
-      scope->threads .insert(thr);
+      scope_thread_insert(scope, thr);
       return thr;
 }
 
@@ -594,11 +799,14 @@ static void child_delete(vthread_t base)
 
 void vthreads_delete(struct __vpiScope*scope)
 {
-      for (std::set<vthread_t>::iterator cur = scope->threads.begin()
-		 ; cur != scope->threads.end() ; ++ cur ) {
-	    delete *cur;
+      while (vthread_t thr = scope->threads) {
+	    scope_thread_erase(scope, thr);
+	    delete thr;
+      }
+      while (vthread_t thr = scope->free_threads) {
+	    scope->free_threads = thr->wait_next;
+	    delete thr;
       }
-      scope->threads.clear();
 }
 #endif
 
@@ -609,24 +817,23 @@ void vthreads_delete(struct __vpiScope*scope)
 static void vthread_reap(vthread_t thr)
 {
       if (! thr->children.empty()) {
-	    for (set<vthread_t>::iterator cur = thr->children.begin()
-		       ; cur != thr->children.end() ; ++cur) {
-		  vthread_t child = *cur;
-		  assert(child);
+	    for (vthread_t child = thr->children.front()
+		       ; child ; child = child->sib_next) {
 		  assert(child->parent == thr);
 		  child->parent = thr->parent;
+		  child->i_am_task_func = 0;
 	    }
+	    thr->children.clear();
       }
       if (! thr->detached_children.empty()) {
-	    for (set<vthread_t>::iterator cur = thr->detached_children.begin()
-		       ; cur != thr->detached_children.end() ; ++cur) {
-		  vthread_t child = *cur;
-		  assert(child);
+	    for (vthread_t child = thr->detached_children.front()
+		       ; child ; child = child->sib_next) {
 		  assert(child->parent == thr);
 		  assert(child->i_am_detached);
 		  child->parent = 0;
 		  child->i_am_detached = 0;
 	    }
+	    thr->detached_children.clear();
       }
       if (thr->parent) {
 	      /* assert that the given element was removed. */
@@ -637,12 +844,16 @@ static void vthread_reap(vthread_t thr)
 		  size_t res = thr->parent->children.erase(thr);
 		  assert(res == 1);
 	    }
+	    if (thr->i_am_task_func) {
+		  thr->parent->task_func_children -= 1;
+		  thr->i_am_task_func = 0;
+	    }
       }
 
       thr->parent = 0;
 
 	// Remove myself from the containing scope if needed.
-      thr->parent_scope->threads.erase(thr);
+      scope_thread_erase(thr->parent_scope, thr);
 
       thr->pc = codespace_null();
 
@@ -659,10 +870,24 @@ static void vthread_reap(vthread_t thr)
       }
 }
 
+/*
+ * A deleted thread is not freed, but kept in a list in its scope so
+ * that the next thread in that scope can use it again. The stacks keep
+ * their capacity, so a scope that forks or calls the same code over
+ * and over stops growing its stacks once they have reached the depth
+ * the code needs. Like the free contexts, the list never holds more
+ * threads than the scope ever had running at once.
+ */
 void vthread_delete(vthread_t thr)
 {
       thr->cleanup();
-      delete thr;
+      thr->args_real.clear();
+      thr->args_str.clear();
+      thr->args_vec4.clear();
+
+      __vpiScope*scope = thr->parent_scope;
+      thr->wait_next = scope->free_threads;
+      scope->free_threads = thr;
 }
 
 void vthread_mark_scheduled(vthread_t thr)
@@ -680,6 +905,49 @@ void vthread_delay_delete()
 	    running_thread->delay_delete = 1;
 }
 
+/*
+ * This is the same as vthread_run, but it also counts the opcodes for
+ * the profiler. The scope and line are kept in locals, because the
+ * thread may be gone when the opcode that stops it returns.
+ */
+static void vthread_run_profiled_(vthread_t thr)
+{
+      while (thr != 0) {
+	    vthread_t tmp = thr->wait_next;
+	    thr->wait_next = 0;
+
+	    assert(thr->is_scheduled);
+	    thr->is_scheduled = 0;
+
+            running_thread = thr;
+
+	    __vpiScope*scope = thr->parent_scope;
+	    vpiHandle line = thr->prof_line;
+	    unsigned long count = 0;
+	    for (;;) {
+		  vvp_code_t cp = thr->pc;
+		  thr->pc += 1;
+
+		  if (cp->opcode == &of_FILE_LINE) {
+			profile_count_opcodes(scope, line, count);
+			count = 0;
+			line = cp->handle;
+			thr->prof_line = line;
+		  }
+		  count += 1;
+		  profile_count_opcode(cp->opcode);
+
+		  bool rc = (cp->opcode)(thr, cp);
+		  if (rc == false)
+			break;
+	    }
+	    profile_count_opcodes(scope, line, count);
+
+	    thr = tmp;
+      }
+      running_thread = 0;
+}
+
 /*
  * This function runs each thread by fetching an instruction,
  * incrementing the PC, and executing the instruction. The thread may
@@ -687,6 +955,11 @@ void vthread_delay_delete()
  */
 void vthread_run(vthread_t thr)
 {
+      if (profile_flag) {
+	    vthread_run_profiled_(thr);
+	    return;
+      }
+
       while (thr != 0) {
 	    vthread_t tmp = thr->wait_next;
 	    thr->wait_next = 0;
@@ -1324,7 +1597,8 @@ static bool do_callf_void(vthread_t thr, vthread_t child)
         // Execute the function. This SHOULD run the function to completion,
         // but there are some exceptional situations where it won't.
       assert(child->parent_scope->get_type_code() == vpiFunction);
-      thr->task_func_children.insert(child);
+      child->i_am_task_func = 1;
+      thr->task_func_children += 1;
       child->is_scheduled = 1;
       child->i_am_in_function = 1;
       vthread_run(child);
@@ -2473,7 +2747,7 @@ static bool do_disable(vthread_t thr, vthread_t match)
       bool flag = false;
 
 	/* Pull the target thread out of its scope if needed. */
-      thr->parent_scope->threads.erase(thr);
+      scope_thread_erase(thr->parent_scope, thr);
 
 	/* Turn the thread off by setting is program counter to
 	   zero and setting an OFF bit. */
@@ -2486,7 +2760,7 @@ static bool do_disable(vthread_t thr, vthread_t match)
 	   %forks that this thread has done. */
       while (! thr->children.empty()) {
 
-	    vthread_t tmp = *(thr->children.begin());
+	    vthread_t tmp = thr->children.front();
 	    assert(tmp);
 	    assert(tmp->parent == thr);
 	    thr->i_am_joining = 0;
@@ -2533,10 +2807,9 @@ bool of_DISABLE(vthread_t thr, vvp_code_t cp)
 
       bool disabled_myself_flag = false;
 
-      while (! scope->threads.empty()) {
-	    set<vthread_t>::iterator cur = scope->threads.begin();
+      while (vthread_t cur = scope->threads) {
 
-	    if (do_disable(*cur, thr))
+	    if (do_disable(cur, thr))
 		  disabled_myself_flag = true;
       }
 
@@ -2558,7 +2831,7 @@ bool of_DISABLE_FORK(vthread_t thr, vvp_code_t)
 
 	/* Disable any detached children. */
       while (! thr->detached_children.empty()) {
-	    vthread_t child = *(thr->detached_children.begin());
+	    vthread_t child = thr->detached_children.front();
 	    assert(child);
 	    assert(child->parent == thr);
 	      /* Disabling the children can never match the parent thread. */
@@ -2898,13 +3171,13 @@ bool of_END(vthread_t thr, vvp_code_t)
 
 	/* Fully detach any detached children. */
       while (! thr->detached_children.empty()) {
-	    vthread_t child = *(thr->detached_children.begin());
+	    vthread_t child = thr->detached_children.front();
 	    assert(child);
 	    assert(child->parent == thr);
 	    assert(child->i_am_detached);
 	    child->parent = 0;
 	    child->i_am_detached = 0;
-	    thr->detached_children.erase(thr->detached_children.begin());
+	    thr->detached_children.erase(child);
       }
 
 	/* It is an error to still have active children running at this
@@ -3241,7 +3514,8 @@ bool of_FORK(vthread_t thr, vvp_code_t cp)
 	      // NOT by the %fork instruction
 	    assert(0);
           case vpiTask:
-	    thr->task_func_children.insert(child);
+	    child->i_am_task_func = 1;
+	    thr->task_func_children += 1;
 	    break;
           default:
 	    break;
@@ -3577,8 +3851,7 @@ bool of_JMP1XZ(vthread_t thr, vvp_code_t cp)
 
 static bool test_joinable(vthread_t thr, vthread_t child)
 {
-      set<vthread_t>::iterator cur = thr->task_func_children.find(child);
-      if (! thr->task_func_children.empty() && cur == thr->task_func_children.end())
+      if (thr->task_func_children > 0 && ! child->i_am_task_func)
 	    return false;
 
       return true;
@@ -3588,8 +3861,11 @@ static void do_join(vthread_t thr, vthread_t child)
 {
       assert(child->parent == thr);
 
-	/* Remove the thread from the task/function set if needed. */
-      thr->task_func_children.erase(child);
+	/* Remove the thread from the task/function count if needed. */
+      if (child->i_am_task_func) {
+	    thr->task_func_children -= 1;
+	    child->i_am_task_func = 0;
+      }
 
         /* If the immediate child thread is in an automatic scope... */
       if (child->wt_context) {
@@ -3615,9 +3891,8 @@ static bool do_join_opcode(vthread_t thr)
 
 	// Are there any children that have already ended? If so, then
 	// join with that one.
-      for (set<vthread_t>::iterator cur = thr->children.begin()
-		 ; cur != thr->children.end() ; ++cur) {
-	    vthread_t curp = *cur;
+      for (vthread_t curp = thr->children.front()
+		 ; curp ; curp = curp->sib_next) {
 	    if (! curp->i_have_ended)
 		  continue;
 
@@ -3648,11 +3923,11 @@ bool of_JOIN_DETACH(vthread_t thr, vvp_code_t cp)
 {
       unsigned long count = cp->number;
 
-      assert(thr->task_func_children.empty());
+      assert(thr->task_func_children == 0);
       assert(count == thr->children.size());
 
       while (! thr->children.empty()) {
-	    vthread_t child = *thr->children.begin();
+	    vthread_t child = thr->children.front();
 	    assert(child->parent == thr);
 
 	      // We cannot detach automatic tasks/functions within an
@@ -26,7 +26,6 @@
 /* Routines used to cleanup the runtime memory when it is all finished. */
 
 extern void codespace_delete(void);
-extern void dec_str_delete(void);
 extern void def_table_delete(void);
 extern void island_delete(void);
 extern void vpi_mcd_delete(void);
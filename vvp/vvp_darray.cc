@@ -488,17 +488,7 @@ void vvp_queue_real::push_front(double value, unsigned max_size)
 
 void vvp_queue_real::erase(unsigned idx)
 {
-      std::deque<double>::iterator pos;
-      unsigned middle = queue.size()/2;
-      if (idx < middle) {
-	    pos = queue.begin();
-	    for (unsigned count = 0; count < idx; ++count) ++pos;
-      } else {
-	    pos = queue.end();
-	    for (unsigned count = queue.size(); count > idx; --count) --pos;
-      }
-
-      queue.erase(pos);
+      queue.erase(idx);
 }
 
 vvp_queue_string::~vvp_queue_string()
@@ -549,17 +539,7 @@ void vvp_queue_string::push_front(const string&value, unsigned max_size)
 
 void vvp_queue_string::erase(unsigned idx)
 {
-      std::deque<std::string>::iterator pos;
-      unsigned middle = queue.size()/2;
-      if (idx < middle) {
-	    pos = queue.begin();
-	    for (unsigned count = 0; count < idx; ++count) ++pos;
-      } else {
-	    pos = queue.end();
-	    for (unsigned count = queue.size(); count > idx; --count) --pos;
-      }
-
-      queue.erase(pos);
+      queue.erase(idx);
 }
 
 vvp_queue_vec4::~vvp_queue_vec4()
@@ -610,15 +590,5 @@ void vvp_queue_vec4::push_front(const vvp_vector4_t&value, unsigned max_size)
 
 void vvp_queue_vec4::erase(unsigned idx)
 {
-      std::deque<vvp_vector4_t>::iterator pos;
-      unsigned middle = queue.size()/2;
-      if (idx < middle) {
-	    pos = queue.begin();
-	    for (unsigned count = 0; count < idx; ++count) ++pos;
-      } else {
-	    pos = queue.end();
-	    for (unsigned count = queue.size(); count > idx; --count) --pos;
-      }
-
-      queue.erase(pos);
+      queue.erase(idx);
 }
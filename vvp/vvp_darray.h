@@ -21,7 +21,6 @@
 
 # include  "vvp_object.h"
 # include  "vvp_net.h"
-# include  <deque>
 # include  <string>
 # include  <vector>
 
@@ -148,6 +147,78 @@ class vvp_darray_object : public vvp_darray {
       std::vector<vvp_object_t> array_;
 };
 
+/*
+ * This is the storage for the queue classes. It is a ring buffer with
+ * a power of two capacity, so indexed access is a mask and an add, and
+ * pushing or popping at either end does not allocate once the queue
+ * has reached its working size. Popped elements are left constructed
+ * in their slots and the next push assigns over them, which lets wide
+ * vectors and strings reuse their storage.
+ */
+template <class T> class vvp_ring {
+
+    public:
+      inline vvp_ring() : head_(0), count_(0) { }
+
+      size_t size(void) const { return count_; }
+      bool empty(void) const { return count_ == 0; }
+
+      T& operator[] (size_t idx)
+      { return buf_[(head_+idx) & (buf_.size()-1)]; }
+      const T& operator[] (size_t idx) const
+      { return buf_[(head_+idx) & (buf_.size()-1)]; }
+
+      T& front(void) { return (*this)[0]; }
+      T& back(void) { return (*this)[count_-1]; }
+
+      void push_back(const T&val)
+      { if (count_ == buf_.size()) grow_();
+	(*this)[count_] = val;
+	count_ += 1;
+      }
+      void push_front(const T&val)
+      { if (count_ == buf_.size()) grow_();
+	head_ = (head_ + buf_.size() - 1) & (buf_.size()-1);
+	buf_[head_] = val;
+	count_ += 1;
+      }
+      void pop_back(void) { count_ -= 1; }
+      void pop_front(void)
+      { head_ = (head_+1) & (buf_.size()-1);
+	count_ -= 1;
+      }
+	// Remove the element at idx, moving the shorter side over it.
+      void erase(size_t idx);
+
+    private:
+      void grow_(void);
+
+      std::vector<T> buf_;
+      size_t head_, count_;
+};
+
+template <class T> void vvp_ring<T>::erase(size_t idx)
+{
+      if (idx < count_/2) {
+	    for (size_t cur = idx ; cur > 0 ; cur -= 1)
+		  (*this)[cur] = (*this)[cur-1];
+	    pop_front();
+      } else {
+	    for (size_t cur = idx+1 ; cur < count_ ; cur += 1)
+		  (*this)[cur-1] = (*this)[cur];
+	    pop_back();
+      }
+}
+
+template <class T> void vvp_ring<T>::grow_(void)
+{
+      std::vector<T> tmp (buf_.empty()? 8 : 2*buf_.size());
+      for (size_t idx = 0 ; idx < count_ ; idx += 1)
+	    tmp[idx] = (*this)[idx];
+      buf_.swap(tmp);
+      head_ = 0;
+}
+
 class vvp_queue : public vvp_darray {
 
     public:
@@ -183,7 +254,7 @@ class vvp_queue_real : public vvp_queue {
       void erase(unsigned idx);
 
     private:
-      std::deque<double> queue;
+      vvp_ring<double> queue;
 };
 
 class vvp_queue_string : public vvp_queue {
@@ -201,7 +272,7 @@ class vvp_queue_string : public vvp_queue {
       void erase(unsigned idx);
 
     private:
-      std::deque<std::string> queue;
+      vvp_ring<std::string> queue;
 };
 
 class vvp_queue_vec4 : public vvp_queue {
@@ -219,7 +290,7 @@ class vvp_queue_vec4 : public vvp_queue {
       void erase(unsigned idx);
 
     private:
-      std::deque<vvp_vector4_t> queue;
+      vvp_ring<vvp_vector4_t> queue;
 };
 
 #endif /* IVL_vvp_darray_H */
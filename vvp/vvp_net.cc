@@ -33,6 +33,7 @@
 # include  <climits>
 # include  <cmath>
 # include  <cassert>
+# include  <algorithm>
 #ifdef CHECK_WITH_VALGRIND
 # include  <valgrind/memcheck.h>
 # include  <map>
@@ -52,10 +53,10 @@ permaheap vvp_net_fil_t::heap_;
 // Allocate around 1Megabyte/chunk.
 static const size_t VVP_NET_CHUNK = 1024*1024/sizeof(vvp_net_t);
 static vvp_net_t*vvp_net_alloc_table = NULL;
-#ifdef CHECK_WITH_VALGRIND
+  // The chunks are remembered so that vvp_net_compact_fanout() can
+  // visit all the nets.
 static vvp_net_t **vvp_net_pool = NULL;
 static unsigned vvp_net_pool_count = 0;
-#endif
 static size_t vvp_net_alloc_remaining = 0;
 // For statistics, count the vvp_nets allocated and the bytes of alloc
 // chunks allocated.
@@ -69,13 +70,13 @@ void* vvp_net_t::operator new (size_t size)
 	    vvp_net_alloc_table = ::new vvp_net_t[VVP_NET_CHUNK];
 	    vvp_net_alloc_remaining = VVP_NET_CHUNK;
 	    size_vvp_nets += size*VVP_NET_CHUNK;
-#ifdef CHECK_WITH_VALGRIND
-	    VALGRIND_MAKE_MEM_NOACCESS(vvp_net_alloc_table, size*VVP_NET_CHUNK);
-	    VALGRIND_CREATE_MEMPOOL(vvp_net_alloc_table, 0, 0);
 	    vvp_net_pool_count += 1;
 	    vvp_net_pool = (vvp_net_t **) realloc(vvp_net_pool,
 	                   vvp_net_pool_count*sizeof(vvp_net_t **));
 	    vvp_net_pool[vvp_net_pool_count-1] = vvp_net_alloc_table;
+#ifdef CHECK_WITH_VALGRIND
+	    VALGRIND_MAKE_MEM_NOACCESS(vvp_net_alloc_table, size*VVP_NET_CHUNK);
+	    VALGRIND_CREATE_MEMPOOL(vvp_net_alloc_table, 0, 0);
 #endif
       }
 
@@ -127,6 +128,9 @@ void vvp_net_delete(vvp_net_t *item)
       if (vvp_fun_signal_string_sa*tmp = dynamic_cast<vvp_fun_signal_string_sa*> (item->fun)) {
 	    delete tmp;
       }
+      if (vvp_fun_fanout*tmp = dynamic_cast<vvp_fun_fanout*> (item->fun)) {
+	    delete tmp;
+      }
 }
 
 void vvp_net_pool_delete()
@@ -228,8 +232,19 @@ void vvp_net_t::unlink(vvp_net_ptr_t dst_ptr)
 		  cur_net = cur.ptr();
 		  cur_port = cur.port();
 	    }
-	      /* Unlink. */
-	    if (cur_net) cur_net->port[cur_port] = net->port[net_port];
+	      /* Unlink. If the pointer is not in the chain, then it
+		 may have been moved to a compacted fan-out. */
+	    if (cur_net) {
+		  cur_net->port[cur_port] = net->port[net_port];
+	    } else {
+		  cur = out_;
+		  while ((cur_net = cur.ptr())) {
+			vvp_fun_fanout*fan = dynamic_cast<vvp_fun_fanout*>(cur_net->fun);
+			if (fan && fan->unlink(dst_ptr))
+			      break;
+			cur = cur_net->port[cur.port()];
+		  }
+	    }
       }
 
       net->port[net_port] = vvp_net_ptr_t(0,0);
@@ -2200,43 +2215,181 @@ vvp_vector4_t vvp_vector4array_t::get_word_(v4cell*cell) const
       return res;
 }
 
-vvp_vector4array_sa::vvp_vector4array_sa(unsigned width__, unsigned words__)
-: vvp_vector4array_t(width__, words__)
+void vvp_vector4array_t::set_word_(unsigned long*bits, const vvp_vector4_t&that)
 {
-      array_ = new v4cell[words_];
+      assert(that.size_ == width_);
 
       if (width_ <= vvp_vector4_t::BITS_PER_WORD) {
-	    for (unsigned idx = 0 ; idx < words_ ; idx += 1) {
-		  array_[idx].abits_val_ = vvp_vector4_t::WORD_X_ABITS;
-		  array_[idx].bbits_val_ = vvp_vector4_t::WORD_X_BBITS;
-	    }
+	    bits[0] = that.abits_val_;
+	    bits[1] = that.bbits_val_;
+	    return;
+      }
+
+      unsigned cnt = word_stride();
+      memcpy(bits, that.abits_ptr_, cnt*sizeof(unsigned long));
+      memcpy(bits+cnt, that.bbits_ptr_, cnt*sizeof(unsigned long));
+}
+
+vvp_vector4_t vvp_vector4array_t::get_word_(const unsigned long*bits) const
+{
+      if (width_ <= vvp_vector4_t::BITS_PER_WORD) {
+	    vvp_vector4_t res;
+	    res.size_ = width_;
+	    res.abits_val_ = bits[0];
+	    res.bbits_val_ = bits[1];
+	    return res;
+      }
+
+      vvp_vector4_t res (width_, BIT4_X);
+      unsigned cnt = word_stride();
+      memcpy(res.abits_ptr_, bits, cnt*sizeof(unsigned long));
+      memcpy(res.bbits_ptr_, bits+cnt, cnt*sizeof(unsigned long));
+      return res;
+}
+
+void vvp_vector4array_t::get_word_bits(unsigned idx, unsigned long*abits,
+				       unsigned long*bbits) const
+{
+      vvp_vector4_t tmp = get_word(idx);
+
+      if (width_ <= vvp_vector4_t::BITS_PER_WORD) {
+	    abits[0] = tmp.abits_val_;
+	    bbits[0] = tmp.bbits_val_;
+	    return;
+      }
+
+      unsigned cnt = word_stride();
+      memcpy(abits, tmp.abits_ptr_, cnt*sizeof(unsigned long));
+      memcpy(bbits, tmp.bbits_ptr_, cnt*sizeof(unsigned long));
+}
+
+void vvp_vector4array_t::set_word_bits(unsigned idx, const unsigned long*abits,
+				       const unsigned long*bbits)
+{
+      vvp_vector4_t tmp (width_);
+
+      if (width_ <= vvp_vector4_t::BITS_PER_WORD) {
+	    tmp.abits_val_ = abits[0];
+	    tmp.bbits_val_ = bbits[0];
       } else {
-	    for (unsigned idx = 0 ; idx < words_ ; idx += 1) {
-		  array_[idx].abits_ptr_ = 0;
-		  array_[idx].bbits_ptr_ = 0;
-	    }
+	    unsigned cnt = word_stride();
+	    memcpy(tmp.abits_ptr_, abits, cnt*sizeof(unsigned long));
+	    memcpy(tmp.bbits_ptr_, bbits, cnt*sizeof(unsigned long));
       }
+
+      set_word(idx, tmp);
+}
+
+size_t vvp_sparse_array_threshold = 64*1024*1024;
+
+  /* The target size of a page of sparse array words. */
+static const size_t SPARSE_ARRAY_PAGE_BYTES = 64*1024;
+
+vvp_vector4array_sa::vvp_vector4array_sa(unsigned width__, unsigned words__)
+: vvp_vector4array_t(width__, words__)
+{
+      slab_ = 0;
+      pages_ = 0;
+      npages_ = 0;
+      page_shift_ = 0;
+
+      size_t word_bytes = 2 * word_stride() * sizeof(unsigned long);
+      size_var_array_logical += (size_t)words_ * word_bytes;
+
+	// Wide words are stored in pages, so that no storage is
+	// allocated for words that are never written. Narrow words
+	// take no more room than a pointer to a page would, so they go
+	// in one slab unless the array is over the threshold.
+      if (width_ > vvp_vector4_t::BITS_PER_WORD
+	  || (size_t)words_ * word_bytes >= vvp_sparse_array_threshold) {
+	    while (page_shift_ < 31 && (1U << page_shift_) < words_
+		   && (word_bytes << (page_shift_+1)) <= SPARSE_ARRAY_PAGE_BYTES)
+		  page_shift_ += 1;
+
+	    npages_ = (words_ + (1U << page_shift_) - 1) >> page_shift_;
+	    pages_ = new unsigned long*[npages_];
+	    for (unsigned idx = 0 ; idx < npages_ ; idx += 1)
+		  pages_[idx] = 0;
+
+	    size_var_array_resident += npages_ * sizeof(unsigned long*);
+	    return;
+      }
+
+      slab_ = alloc_words_(words_);
 }
 
 vvp_vector4array_sa::~vvp_vector4array_sa()
 {
-      if (array_) {
-	    if (width_ > vvp_vector4_t::BITS_PER_WORD) {
-		  for (unsigned idx = 0 ; idx < words_ ; idx += 1)
-			if (array_[idx].abits_ptr_)
-			      delete[]array_[idx].abits_ptr_;
+      delete[]slab_;
+
+      if (pages_) {
+	    for (unsigned idx = 0 ; idx < npages_ ; idx += 1)
+		  delete[]pages_[idx];
+	    delete[]pages_;
+      }
+}
+
+/*
+ * Allocate storage for a block of words, all initialized to X.
+ */
+unsigned long* vvp_vector4array_sa::alloc_words_(size_t count)
+{
+      unsigned cnt = word_stride();
+      size_t nlongs = 2 * cnt * count;
+      unsigned long*bits = new unsigned long[nlongs];
+      for (size_t idx = 0 ; idx < nlongs ; idx += 2*cnt) {
+	    for (unsigned n = 0 ; n < cnt ; n += 1) {
+		  bits[idx+n] = vvp_vector4_t::WORD_X_ABITS;
+		  bits[idx+cnt+n] = vvp_vector4_t::WORD_X_BBITS;
 	    }
-	    delete[]array_;
       }
+
+      size_var_array_resident += nlongs * sizeof(unsigned long);
+      return bits;
 }
 
-void vvp_vector4array_sa::set_word(unsigned index, const vvp_vector4_t&that)
+/*
+ * Return a pointer to the bits of the word, or nil if the word is in
+ * a page that has not been allocated yet.
+ */
+const unsigned long* vvp_vector4array_sa::word_bits_(unsigned index) const
 {
       assert(index < words_);
 
-      v4cell*cell = &array_[index];
+      if (slab_)
+	    return slab_ + (size_t)2*word_stride()*index;
 
-      set_word_(cell, that);
+      const unsigned long*page = pages_[index >> page_shift_];
+      if (page == 0)
+	    return 0;
+
+      unsigned off = index & ((1U << page_shift_) - 1);
+      return page + (size_t)2*word_stride()*off;
+}
+
+/*
+ * Return a pointer to the bits of the word for writing, allocating
+ * the page that holds the word if necessary.
+ */
+unsigned long* vvp_vector4array_sa::word_bits_wr_(unsigned index)
+{
+      assert(index < words_);
+
+      if (slab_)
+	    return slab_ + (size_t)2*word_stride()*index;
+
+      unsigned page = index >> page_shift_;
+      if (pages_[page] == 0)
+	    pages_[page] = alloc_words_((size_t)1 << page_shift_);
+
+      unsigned off = index & ((1U << page_shift_) - 1);
+      return pages_[page] + (size_t)2*word_stride()*off;
+}
+
+void vvp_vector4array_sa::set_word(unsigned index, const vvp_vector4_t&that)
+{
+      assert(index < words_);
+      set_word_(word_bits_wr_(index), that);
 }
 
 vvp_vector4_t vvp_vector4array_sa::get_word(unsigned index) const
@@ -2244,11 +2397,40 @@ vvp_vector4_t vvp_vector4array_sa::get_word(unsigned index) const
       if (index >= words_)
 	    return vvp_vector4_t(width_, BIT4_X);
 
-      assert(index < words_);
+      const unsigned long*bits = word_bits_(index);
+      if (bits == 0)
+	    return vvp_vector4_t(width_, BIT4_X);
 
-      v4cell*cell = &array_[index];
+      return get_word_(bits);
+}
 
-      return get_word_(cell);
+void vvp_vector4array_sa::get_word_bits(unsigned index, unsigned long*abits,
+				        unsigned long*bbits) const
+{
+      unsigned cnt = word_stride();
+      const unsigned long*bits = index < words_? word_bits_(index) : 0;
+
+      if (bits == 0) {
+	    for (unsigned idx = 0 ; idx < cnt ; idx += 1) {
+		  abits[idx] = vvp_vector4_t::WORD_X_ABITS;
+		  bbits[idx] = vvp_vector4_t::WORD_X_BBITS;
+	    }
+	    return;
+      }
+
+      memcpy(abits, bits, cnt*sizeof(unsigned long));
+      memcpy(bbits, bits+cnt, cnt*sizeof(unsigned long));
+}
+
+void vvp_vector4array_sa::set_word_bits(unsigned index, const unsigned long*abits,
+				        const unsigned long*bbits)
+{
+      assert(index < words_);
+
+      unsigned cnt = word_stride();
+      unsigned long*bits = word_bits_wr_(index);
+      memcpy(bits, abits, cnt*sizeof(unsigned long));
+      memcpy(bits+cnt, bbits, cnt*sizeof(unsigned long));
 }
 
 vvp_vector4array_aa::vvp_vector4array_aa(unsigned width__, unsigned words__)
@@ -3147,8 +3329,8 @@ vvp_vector8_t vvp_vector8_t::subvalue(unsigned base, unsigned wid) const
 void vvp_vector8_t::set_vec(unsigned base, const vvp_vector8_t&that)
 {
       assert((base+that.size()) <= size());
-      for (unsigned idx = 0 ; idx < that.size() ; idx += 1)
-	    set_bit(base+idx, that.value(idx));
+      if (that.size() > 0)
+	    memcpy(bytes_()+base, that.bytes_(), that.size());
 }
 
 vvp_vector8_t part_expand(const vvp_vector8_t&that, unsigned wid, unsigned off)
@@ -3379,6 +3561,221 @@ void vvp_fun_drive::recv_vec4_pv(vvp_net_ptr_t ptr, const vvp_vector4_t&bit,
       recv_vec4_pv_(ptr, bit, base, wid, vwid, ctx);
 }
 
+/* **** vvp_fun_fanout methods **** */
+
+unsigned vvp_fanout_compact_threshold = 256;
+bool vvp_fanout_compact_sort = false;
+
+vvp_fun_fanout::vvp_fun_fanout(const std::vector<vvp_net_ptr_t>&dst)
+: dst_(dst)
+{
+}
+
+vvp_fun_fanout::~vvp_fun_fanout()
+{
+}
+
+/*
+ * The destination is only cleared, not erased, because the unlink may
+ * happen while the array is being scanned by one of the recv methods.
+ */
+bool vvp_fun_fanout::unlink(vvp_net_ptr_t dst)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    if (dst_[idx] == dst) {
+		  dst_[idx] = vvp_net_ptr_t();
+		  return true;
+	    }
+      }
+      return false;
+}
+
+/*
+ * Look this far ahead in the destination array when prefetching the
+ * destination nets.
+ */
+static const size_t FANOUT_PREFETCH = 8;
+
+static inline void fanout_prefetch_(const std::vector<vvp_net_ptr_t>&dst,
+				    size_t idx)
+{
+#if defined(__GNUC__)
+      if (idx + FANOUT_PREFETCH < dst.size())
+	    __builtin_prefetch(dst[idx + FANOUT_PREFETCH].ptr());
+#else
+      (void)dst;
+      (void)idx;
+#endif
+}
+
+void vvp_fun_fanout::recv_vec4(vvp_net_ptr_t, const vvp_vector4_t&bit,
+			       vvp_context_t context)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    fanout_prefetch_(dst_, idx);
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_vec4(ptr, bit, context);
+      }
+}
+
+void vvp_fun_fanout::recv_vec8(vvp_net_ptr_t, const vvp_vector8_t&bit)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    fanout_prefetch_(dst_, idx);
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_vec8(ptr, bit);
+      }
+}
+
+void vvp_fun_fanout::recv_real(vvp_net_ptr_t, double bit,
+			       vvp_context_t context)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    fanout_prefetch_(dst_, idx);
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_real(ptr, bit, context);
+      }
+}
+
+void vvp_fun_fanout::recv_long(vvp_net_ptr_t, long bit)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    fanout_prefetch_(dst_, idx);
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_long(ptr, bit);
+      }
+}
+
+void vvp_fun_fanout::recv_string(vvp_net_ptr_t, const std::string&bit,
+				 vvp_context_t context)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_string(ptr, bit, context);
+      }
+}
+
+void vvp_fun_fanout::recv_object(vvp_net_ptr_t, vvp_object_t bit,
+				 vvp_context_t context)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_object(ptr, bit, context);
+      }
+}
+
+void vvp_fun_fanout::recv_vec4_pv(vvp_net_ptr_t, const vvp_vector4_t&bit,
+				  unsigned base, unsigned wid, unsigned vwid,
+				  vvp_context_t context)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    fanout_prefetch_(dst_, idx);
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_vec4_pv(ptr, bit, base, wid, vwid, context);
+      }
+}
+
+void vvp_fun_fanout::recv_vec8_pv(vvp_net_ptr_t, const vvp_vector8_t&bit,
+				  unsigned base, unsigned wid, unsigned vwid)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    fanout_prefetch_(dst_, idx);
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_vec8_pv(ptr, bit, base, wid, vwid);
+      }
+}
+
+void vvp_fun_fanout::recv_long_pv(vvp_net_ptr_t, long bit,
+				  unsigned base, unsigned wid)
+{
+      for (size_t idx = 0 ; idx < dst_.size() ; idx += 1) {
+	    vvp_net_ptr_t ptr = dst_[idx];
+	    vvp_net_t*cur = ptr.ptr();
+	    if (cur && cur->fun)
+		  cur->fun->recv_long_pv(ptr, bit, base, wid);
+      }
+}
+
+/*
+ * Order the destinations by the type of their functor, so that the
+ * scan calls the same recv method many times in a row. The sort is
+ * stable, so destinations of the same type keep their chain order,
+ * but the order of the types is up to the implementation. This is only
+ * done if asked for (VVP_FANOUT_COMPACT_SORT), since it changes the
+ * order in which the destinations see a new value.
+ */
+static bool fanout_type_less_(vvp_net_ptr_t a, vvp_net_ptr_t b)
+{
+      const vvp_net_fun_t*fa = a.ptr()->fun;
+      const vvp_net_fun_t*fb = b.ptr()->fun;
+      if (fa == 0 || fb == 0)
+	    return fa == 0 && fb != 0;
+      return typeid(*fa).before(typeid(*fb));
+}
+
+void vvp_net_t::compact_fanout_(std::vector<vvp_net_ptr_t>&dst)
+{
+      dst.clear();
+      for (vvp_net_ptr_t cur = out_ ; ! cur.nil() ; ) {
+	    dst.push_back(cur);
+	    cur = cur.ptr()->port[cur.port()];
+      }
+
+      if (dst.size() < vvp_fanout_compact_threshold)
+	    return;
+
+	// Take the destinations out of the chain, and link the
+	// fan-out node in their place.
+      for (size_t idx = 0 ; idx < dst.size() ; idx += 1)
+	    dst[idx].ptr()->port[dst[idx].port()] = vvp_net_ptr_t();
+
+      if (vvp_fanout_compact_sort)
+	    stable_sort(dst.begin(), dst.end(), fanout_type_less_);
+
+      vvp_net_t*fan = new vvp_net_t;
+      fan->fun = new vvp_fun_fanout(dst);
+#ifdef CHECK_WITH_VALGRIND
+      pool_local_net(fan);
+#endif
+      out_ = vvp_net_ptr_t(fan, 0);
+      count_fanout_compacted += 1;
+}
+
+void vvp_net_compact_fanout(void)
+{
+      if (vvp_fanout_compact_threshold == 0)
+	    return;
+
+	// New nets are allocated from the pool as fan-out nodes are
+	// created, so only visit the nets that exist now.
+      const unsigned pool_count = vvp_net_pool_count;
+      const size_t last_count = VVP_NET_CHUNK - vvp_net_alloc_remaining;
+
+      std::vector<vvp_net_ptr_t> dst;
+      for (unsigned pdx = 0 ; pdx < pool_count ; pdx += 1) {
+	    vvp_net_t*chunk = vvp_net_pool[pdx];
+	    size_t count = pdx+1 == pool_count? last_count : VVP_NET_CHUNK;
+	    for (size_t idx = 0 ; idx < count ; idx += 1)
+		  chunk[idx].compact_fanout_(dst);
+      }
+}
+
 /* **** vvp_wide_fun_* methods **** */
 
 vvp_wide_fun_core::vvp_wide_fun_core(vvp_net_t*net, unsigned nports)
@@ -3689,6 +4086,72 @@ vvp_scalar_t fully_featured_resolv_(vvp_scalar_t a, vvp_scalar_t b)
       return res;
 }
 
+/*
+ * Resolve two strength vectors. The vvp_scalar_t bytes are processed
+ * 8 at a time as a uint64_t. For every byte where one side is HiZ or
+ * both sides are identical, the result is simply one of the inputs,
+ * and that selection can be done for the whole word at once. Only the
+ * bytes that are in real conflict are passed to the scalar resolver.
+ */
+static inline uint64_t vec8_zero_bytes_(uint64_t x)
+{
+	// Return 0x80 in every byte of x that is zero.
+      const uint64_t low7 = 0x7f7f7f7f7f7f7f7fULL;
+      return ~(((x & low7) + low7) | x) & ~low7;
+}
+
+vvp_vector8_t resolve(const vvp_vector8_t&a, const vvp_vector8_t&b)
+{
+      assert(a.size() == b.size());
+      const unsigned wid = a.size();
+      vvp_vector8_t out (wid);
+
+      const unsigned char*ap = a.bytes_();
+      const unsigned char*bp = b.bytes_();
+      unsigned char*op = out.bytes_();
+
+      const uint64_t hiz_mask = 0x7777777777777777ULL;
+
+      for (unsigned base = 0 ;  base < wid ;  base += 8) {
+	    unsigned cnt = wid - base;
+	    if (cnt > 8) cnt = 8;
+
+	      // Zero padding is HiZ on both sides, so it resolves
+	      // trivially and is never written back.
+	    uint64_t aw = 0, bw = 0;
+	    memcpy(&aw, ap+base, cnt);
+	    memcpy(&bw, bp+base, cnt);
+
+	    uint64_t a_hiz = vec8_zero_bytes_(aw & hiz_mask);
+	    uint64_t b_hiz = vec8_zero_bytes_(bw & hiz_mask);
+	    uint64_t same  = vec8_zero_bytes_(aw ^ bw);
+
+	      // Where a is HiZ take b, otherwise take a. This is also
+	      // correct where b is HiZ or the bytes are equal.
+	    uint64_t take_b = (a_hiz >> 7) * 0xff;
+	    uint64_t ow = (aw & ~take_b) | (bw & take_b);
+
+	    uint64_t conflict = ~(a_hiz | b_hiz | same) & 0x8080808080808080ULL;
+	    memcpy(op+base, &ow, cnt);
+
+	    if (conflict == 0)
+		  continue;
+
+	      // Unpack the flags the same way the bytes were packed so
+	      // that this does not depend on the host byte order.
+	    unsigned char flags[8];
+	    memcpy(flags, &conflict, sizeof flags);
+	    for (unsigned idx = 0 ;  idx < cnt ;  idx += 1) {
+		  if (flags[idx] == 0)
+			continue;
+		  op[base+idx] = fully_featured_resolv_(vvp_scalar_t(ap[base+idx]),
+							vvp_scalar_t(bp[base+idx])).raw();
+	    }
+      }
+
+      return out;
+}
+
 unsigned vvp_switch_strength_map[2][8] = {
       {  // non-resistive
 	    0, /* High impedance   --> High impedance   */
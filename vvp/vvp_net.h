@@ -28,6 +28,7 @@
 # include  <cstdlib>
 # include  <cstring>
 # include  <string>
+# include  <vector>
 # include  <new>
 # include  <cassert>
 
@@ -65,17 +66,14 @@ class  vvp_delay_t;
  * Storage for items declared in automatically allocated scopes (i.e. automatic
  * tasks and functions). The first two slots in each context are reserved for
  * linking to other contexts. The function that adds items to a context knows
- * this, and allocates context indices accordingly.
+ * this, and allocates context indices accordingly. The context is allocated
+ * by vthread_alloc_context(), which may also place the item storage in the
+ * same block.
  */
 typedef void**vvp_context_t;
 
 typedef void*vvp_context_item_t;
 
-inline vvp_context_t vvp_allocate_context(unsigned nitem)
-{
-      return (vvp_context_t)malloc((2 + nitem) * sizeof(void*));
-}
-
 inline vvp_context_t vvp_get_next_context(vvp_context_t context)
 {
       return (vvp_context_t)context[0];
@@ -112,12 +110,20 @@ inline void vvp_set_context_item(vvp_context_t context, unsigned item_idx,
  * An "automatic" functor is one which may be associated with an automatically
  * allocated scope item. This provides the infrastructure needed to allocate
  * the state information for individual instances of the item.
+ *
+ * An item that returns a non-zero instance_size() has its state placed
+ * in the context block itself. The context allocator reserves that
+ * many bytes and stores a pointer to them in the item slot before it
+ * calls alloc_instance(), which then constructs the state in place.
+ * Such an item must not delete its state in free_instance(), only
+ * destroy it.
  */
 struct automatic_hooks_s {
 
       automatic_hooks_s() {}
       virtual ~automatic_hooks_s() {}
 
+      virtual size_t instance_size() const { return 0; }
       virtual void alloc_instance(vvp_context_t context) = 0;
       virtual void reset_instance(vvp_context_t context) = 0;
 #ifdef CHECK_WITH_VALGRIND
@@ -424,8 +430,17 @@ inline vvp_vector4_t& vvp_vector4_t::operator= (const vvp_vector4_t&that)
       if (this == &that)
 	    return *this;
 
-      if (size_ > BITS_PER_WORD)
+      if (size_ > BITS_PER_WORD) {
+	      // A wide vector of the same width can be copied in
+	      // place. The b bits follow the a bits in the same array.
+	    if (size_ == that.size_) {
+		  unsigned words = (size_+BITS_PER_WORD-1) / BITS_PER_WORD;
+		  for (unsigned idx = 0 ; idx < 2*words ; idx += 1)
+			abits_ptr_[idx] = that.abits_ptr_[idx];
+		  return *this;
+	    }
 	    delete[] abits_ptr_;
+      }
 
       copy_from_(that);
 
@@ -589,6 +604,20 @@ class vvp_vector4array_t {
       virtual vvp_vector4_t get_word(unsigned idx) const = 0;
       virtual void set_word(unsigned idx, const vvp_vector4_t&that) = 0;
 
+	// Number of unsigned longs needed for each of the a and b
+	// bits of a word.
+      unsigned word_stride() const
+      { return (width_ + vvp_vector4_t::BITS_PER_WORD-1) / vvp_vector4_t::BITS_PER_WORD; }
+
+	// Copy the a and b bits of a word to or from arrays of
+	// word_stride() unsigned longs, using the vvp_vector4_t
+	// encoding. Derived classes may override these to avoid
+	// making a temporary vvp_vector4_t.
+      virtual void get_word_bits(unsigned idx, unsigned long*abits,
+				 unsigned long*bbits) const;
+      virtual void set_word_bits(unsigned idx, const unsigned long*abits,
+				 const unsigned long*bbits);
+
     protected:
       struct v4cell {
 	    union {
@@ -604,6 +633,11 @@ class vvp_vector4array_t {
       vvp_vector4_t get_word_(v4cell*cell) const;
       void set_word_(v4cell*cell, const vvp_vector4_t&that);
 
+	// Get/set a word stored as its a bits followed by its b bits,
+	// each taking word_stride() unsigned longs.
+      vvp_vector4_t get_word_(const unsigned long*bits) const;
+      void set_word_(unsigned long*bits, const vvp_vector4_t&that);
+
       unsigned width_;
       unsigned words_;
 
@@ -614,7 +648,20 @@ class vvp_vector4array_t {
 
 /*
  * Statically allocated vvp_vector4array_t
+ *
+ * The words are stored as their a bits followed by their b bits, each
+ * taking word_stride() unsigned longs, so that no word needs its own
+ * allocation.
+ *
+ * Arrays of wide words (more than one unsigned long each), and arrays
+ * whose storage would take at least vvp_sparse_array_threshold bytes,
+ * are stored sparsely. The words are grouped into pages that are only
+ * allocated when a word in the page is first written, and words in
+ * pages that have never been written read as X. The words of other
+ * arrays are all in one contiguous slab.
  */
+extern size_t vvp_sparse_array_threshold;
+
 class vvp_vector4array_sa : public vvp_vector4array_t {
 
     public:
@@ -624,8 +671,23 @@ class vvp_vector4array_sa : public vvp_vector4array_t {
       vvp_vector4_t get_word(unsigned idx) const;
       void set_word(unsigned idx, const vvp_vector4_t&that);
 
+      void get_word_bits(unsigned idx, unsigned long*abits,
+			 unsigned long*bbits) const;
+      void set_word_bits(unsigned idx, const unsigned long*abits,
+			 const unsigned long*bbits);
+
     private:
-      v4cell* array_;
+      unsigned long*alloc_words_(size_t count);
+      const unsigned long*word_bits_(unsigned idx) const;
+      unsigned long*word_bits_wr_(unsigned idx);
+
+	// Dense storage for all the words.
+      unsigned long*slab_;
+
+	// Sparse storage. Each page holds 1<<page_shift_ words.
+      unsigned long**pages_;
+      unsigned npages_;
+      unsigned page_shift_;
 };
 
 /*
@@ -803,6 +865,7 @@ inline vvp_vector2_t vvp_vector2_t::subvalue(unsigned base, unsigned wid) const
 class vvp_scalar_t {
 
       friend vvp_scalar_t fully_featured_resolv_(vvp_scalar_t a, vvp_scalar_t b);
+      friend vvp_vector8_t resolve(const vvp_vector8_t&, const vvp_vector8_t&);
 
     public:
 	// Make a HiZ value.
@@ -909,6 +972,7 @@ extern ostream& operator<< (ostream&, vvp_scalar_t);
 class vvp_vector8_t {
 
       friend vvp_vector8_t part_expand(const vvp_vector8_t&, unsigned, unsigned);
+      friend vvp_vector8_t resolve(const vvp_vector8_t&, const vvp_vector8_t&);
 
     public:
       explicit vvp_vector8_t(unsigned size =0);
@@ -939,6 +1003,13 @@ class vvp_vector8_t {
       vvp_vector8_t(const vvp_vector8_t&that);
       vvp_vector8_t& operator= (const vvp_vector8_t&that);
 
+    private:
+	// Raw access to the vvp_scalar_t encoded bytes.
+      unsigned char*bytes_()
+      { return size_ <= sizeof(val_)? val_ : ptr_; }
+      const unsigned char*bytes_() const
+      { return size_ <= sizeof(val_)? val_ : ptr_; }
+
     private:
       unsigned size_;
       union {
@@ -948,18 +1019,9 @@ class vvp_vector8_t {
 };
 
   /* Resolve uses the default Verilog resolver algorithm to resolve
-     two drive vectors to a single output. */
-inline vvp_vector8_t resolve(const vvp_vector8_t&a, const vvp_vector8_t&b)
-{
-      assert(a.size() == b.size());
-      vvp_vector8_t out (a.size());
-
-      for (unsigned idx = 0 ;  idx < out.size() ;  idx += 1) {
-	    out.set_bit(idx, resolve(a.value(idx), b.value(idx)));
-      }
-
-      return out;
-}
+     two drive vectors to a single output. The common cases (HiZ or
+     identical bits) are resolved a machine word at a time. */
+extern vvp_vector8_t resolve(const vvp_vector8_t&a, const vvp_vector8_t&b);
 
   /* This lookup tabke implements the strength reduction implied by
      Verilog standard switch devices. The major dimension selects
@@ -1161,9 +1223,17 @@ class vvp_net_t {
     public: // Method to support $countdrivers
       void count_drivers(unsigned idx, unsigned counts[4]);
 
+    public: // Method to support levelizing the netlist.
+	// Get the head of the fan-out chain of this net.
+      vvp_net_ptr_t fanout() const { return out_; }
+
     private:
       vvp_net_ptr_t out_;
 
+	// Replace a long fan-out chain with a vvp_fun_fanout node.
+      void compact_fanout_(std::vector<vvp_net_ptr_t>&dst);
+      friend void vvp_net_compact_fanout(void);
+
     public: // Need a better new for these objects.
       static void* operator new(std::size_t size);
       static void operator delete(void*); // not implemented
@@ -1516,6 +1586,59 @@ class vvp_fun_extend_signed  : public vvp_net_fun_t {
       unsigned width_;
 };
 
+/*
+ * The vvp_fun_fanout functor replaces the fan-out chain of a net that
+ * drives very many inputs. The destination ports are kept in a
+ * contiguous array, in chain order, so that propagation is a linear
+ * scan instead of a pointer chase through all the destination nets.
+ * The fan-out net takes the place of the chain in the output of the
+ * driver, so further links made at run time are chained in front of
+ * it as usual. See vvp_net_compact_fanout() below.
+ */
+class vvp_fun_fanout  : public vvp_net_fun_t {
+
+    public:
+      explicit vvp_fun_fanout(const std::vector<vvp_net_ptr_t>&dst);
+      ~vvp_fun_fanout();
+
+	// Remove the destination port from the array. Return false if
+	// this fan-out does not drive that port.
+      bool unlink(vvp_net_ptr_t dst);
+
+      void recv_vec4(vvp_net_ptr_t port, const vvp_vector4_t&bit,
+                     vvp_context_t context);
+      void recv_vec8(vvp_net_ptr_t port, const vvp_vector8_t&bit);
+      void recv_real(vvp_net_ptr_t port, double bit,
+                     vvp_context_t context);
+      void recv_long(vvp_net_ptr_t port, long bit);
+      void recv_string(vvp_net_ptr_t port, const std::string&bit,
+		       vvp_context_t context);
+      void recv_object(vvp_net_ptr_t port, vvp_object_t bit,
+		       vvp_context_t context);
+
+      void recv_vec4_pv(vvp_net_ptr_t port, const vvp_vector4_t&bit,
+			unsigned base, unsigned wid, unsigned vwid,
+                        vvp_context_t context);
+      void recv_vec8_pv(vvp_net_ptr_t port, const vvp_vector8_t&bit,
+			unsigned base, unsigned wid, unsigned vwid);
+      void recv_long_pv(vvp_net_ptr_t port, long bit,
+                        unsigned base, unsigned wid);
+
+    private:
+      std::vector<vvp_net_ptr_t> dst_;
+};
+
+/*
+ * Outputs that drive at least vvp_fanout_compact_threshold inputs are
+ * converted to vvp_fun_fanout nodes by vvp_net_compact_fanout(), which
+ * is called at the end of compile. A threshold of 0 disables this. If
+ * vvp_fanout_compact_sort is set, the destinations are also grouped by
+ * functor type, which changes the order in which they receive values.
+ */
+extern unsigned vvp_fanout_compact_threshold;
+extern bool vvp_fanout_compact_sort;
+extern void vvp_net_compact_fanout(void);
+
 /*
  * Wide Functors:
  * Wide functors represent special devices that may have more than 4
@@ -347,9 +347,14 @@ vvp_fun_signal4_aa::~vvp_fun_signal4_aa()
       assert(0);
 }
 
+size_t vvp_fun_signal4_aa::instance_size() const
+{
+      return sizeof(vvp_vector4_t);
+}
+
 void vvp_fun_signal4_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_set_context_item(context, context_idx_, new vvp_vector4_t(size_));
+      new (vvp_get_context_item(context, context_idx_)) vvp_vector4_t(size_);
 }
 
 void vvp_fun_signal4_aa::reset_instance(vvp_context_t context)
@@ -365,7 +370,7 @@ void vvp_fun_signal4_aa::free_instance(vvp_context_t context)
 {
       vvp_vector4_t*bits = static_cast<vvp_vector4_t*>
             (vvp_get_context_item(context, context_idx_));
-      delete bits;
+      bits->~vvp_vector4_t();
 }
 #endif
 
@@ -506,10 +511,15 @@ vvp_fun_signal_real_aa::~vvp_fun_signal_real_aa()
       assert(0);
 }
 
+size_t vvp_fun_signal_real_aa::instance_size() const
+{
+      return sizeof(double);
+}
+
 void vvp_fun_signal_real_aa::alloc_instance(vvp_context_t context)
 {
-      double*bits = new double;
-      vvp_set_context_item(context, context_idx_, bits);
+      double*bits = static_cast<double*>
+            (vvp_get_context_item(context, context_idx_));
 
       *bits = 0.0;
 }
@@ -523,11 +533,8 @@ void vvp_fun_signal_real_aa::reset_instance(vvp_context_t context)
 }
 
 #ifdef CHECK_WITH_VALGRIND
-void vvp_fun_signal_real_aa::free_instance(vvp_context_t context)
+void vvp_fun_signal_real_aa::free_instance(vvp_context_t)
 {
-      double*bits = static_cast<double*>
-            (vvp_get_context_item(context, context_idx_));
-      delete bits;
 }
 #endif
 
@@ -625,11 +632,14 @@ vvp_fun_signal_string_aa::~vvp_fun_signal_string_aa()
       assert(0);
 }
 
+size_t vvp_fun_signal_string_aa::instance_size() const
+{
+      return sizeof(std::string);
+}
+
 void vvp_fun_signal_string_aa::alloc_instance(vvp_context_t context)
 {
-      string*bits = new std::string;
-      vvp_set_context_item(context, context_idx_, bits);
-      *bits = "";
+      new (vvp_get_context_item(context, context_idx_)) std::string;
 }
 
 void vvp_fun_signal_string_aa::reset_instance(vvp_context_t context)
@@ -644,7 +654,7 @@ void vvp_fun_signal_string_aa::free_instance(vvp_context_t context)
 {
       string*bits = static_cast<std::string*>
             (vvp_get_context_item(context, context_idx_));
-      delete bits;
+      bits->~string();
 }
 #endif
 
@@ -721,7 +731,7 @@ void vvp_fun_signal_object_aa::free_instance(vvp_context_t context)
 {
       vvp_object_t*bits = static_cast<vvp_object_t*>
             (vvp_get_context_item(context, context_idx_));
-      delete bits;
+      bits->~vvp_object_t();
 }
 #endif
 
@@ -754,11 +764,14 @@ vvp_fun_signal_object_aa::~vvp_fun_signal_object_aa()
       assert(0);
 }
 
+size_t vvp_fun_signal_object_aa::instance_size() const
+{
+      return sizeof(vvp_object_t);
+}
+
 void vvp_fun_signal_object_aa::alloc_instance(vvp_context_t context)
 {
-      vvp_object_t*bits = new vvp_object_t;
-      vvp_set_context_item(context, context_idx_, bits);
-      bits->reset();
+      new (vvp_get_context_item(context, context_idx_)) vvp_object_t;
 }
 
 void vvp_fun_signal_object_aa::reset_instance(vvp_context_t context)
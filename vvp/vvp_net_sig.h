@@ -166,6 +166,7 @@ class vvp_fun_signal4_aa : public vvp_fun_signal_vec, public automatic_signal_ba
       explicit vvp_fun_signal4_aa(unsigned wid, vvp_bit4_t init=BIT4_X);
       ~vvp_fun_signal4_aa();
 
+      size_t instance_size() const;
       void alloc_instance(vvp_context_t context);
       void reset_instance(vvp_context_t context);
 #ifdef CHECK_WITH_VALGRIND
@@ -234,6 +235,7 @@ class vvp_fun_signal_real_aa : public vvp_fun_signal_real, public automatic_sign
       explicit vvp_fun_signal_real_aa();
       ~vvp_fun_signal_real_aa();
 
+      size_t instance_size() const;
       void alloc_instance(vvp_context_t context);
       void reset_instance(vvp_context_t context);
 #ifdef CHECK_WITH_VALGRIND
@@ -302,6 +304,7 @@ class vvp_fun_signal_string_aa : public vvp_fun_signal_string, public automatic_
       explicit vvp_fun_signal_string_aa();
       ~vvp_fun_signal_string_aa();
 
+      size_t instance_size() const;
       void alloc_instance(vvp_context_t context);
       void reset_instance(vvp_context_t context);
 #ifdef CHECK_WITH_VALGRIND
@@ -364,6 +367,7 @@ class vvp_fun_signal_object_aa : public vvp_fun_signal_object, public automatic_
       explicit vvp_fun_signal_object_aa(unsigned size);
       ~vvp_fun_signal_object_aa();
 
+      size_t instance_size() const;
       void alloc_instance(vvp_context_t context);
       void reset_instance(vvp_context_t context);
 #ifdef CHECK_WITH_VALGRIND